@@ -0,0 +1,50 @@
+#ifndef KMAT_GEOMETRYLIB_BENCH_H
+#define KMAT_GEOMETRYLIB_BENCH_H
+
+#include <stdbool.h>
+
+
+/*
+ * ------------------------------------
+ * Helpers
+ * ------------------------------------
+ */
+
+/**
+ * @brief Returns a monotonic time stamp
+ *
+ * @return Time in seconds (only differences are meaningful)
+ */
+double bench_now();
+
+
+/*
+ * ------------------------------------
+ * Benchmarks
+ * ------------------------------------
+ */
+
+/**
+ * @brief Times the sweep of get_line_intersections against the brute-force reference on two 50k-point curves
+ *
+ * @return False if the sweep's result differs from the reference
+ */
+bool bench_line_intersections();
+
+/**
+ * @brief Times RDP, Visvalingam and streaming simplification of a noisy 1M-point curve
+ *
+ * @return False if a result breaks the guarantees of simplify_polyline2_indices or the simplifier disagrees with POLYLINE_SIMPLIFY_STREAMING
+ */
+bool bench_simplification();
+
+/**
+ * @brief Times filling, scanning and random gathers of a 256 MiB DataArray1 with and without huge-page backing
+ *
+ * Compares the current threshold of data_array_set_huge_page_threshold with 0 (regular heap) and restores it afterwards.
+ *
+ * @return False if both runs do not compute the same sums
+ */
+bool bench_scan();
+
+#endif //KMAT_GEOMETRYLIB_BENCH_H
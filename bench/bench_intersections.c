@@ -0,0 +1,41 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "geometrylib_linetool.h"
+
+#define BENCH_INTERSECTIONS_NUM_POINTS 50000
+
+bool bench_line_intersections() {
+	// a slow and a fast oscillation over the same x-range that cross about two thousand times
+	DataArray2 *line0 = data_array2_create(), *line1 = data_array2_create();
+	for(int i = 0; i < BENCH_INTERSECTIONS_NUM_POINTS; i++) {
+		double x = i * 0.01;
+		data_array2_append_new(line0, vec2(x, sin(x)));
+		data_array2_append_new(line1, vec2(x + 0.003, sin(13 * x + 0.3)));
+	}
+
+	double start = bench_now();
+	DataArray2 *sweep = get_line_intersections(line0, line1);
+	double sweep_time = bench_now() - start;
+
+	start = bench_now();
+	DataArray2 *reference = get_line_intersections_brute_force(line0, line1);
+	double reference_time = bench_now() - start;
+
+	size_t num_inters = data_array2_size(sweep);
+	bool identical = num_inters == data_array2_size(reference) &&
+		memcmp(data_array2_get_data(sweep), data_array2_get_data(reference), num_inters * sizeof(Vector2)) == 0;
+
+	printf("%d + %d points, %zu intersections\n", BENCH_INTERSECTIONS_NUM_POINTS, BENCH_INTERSECTIONS_NUM_POINTS, num_inters);
+	printf("sweep:       %10.4f s\n", sweep_time);
+	printf("brute force: %10.4f s\n", reference_time);
+	printf("results identical: %s\n", identical ? "yes" : "no");
+
+	data_array2_free(line0);
+	data_array2_free(line1);
+	data_array2_free(sweep);
+	data_array2_free(reference);
+	return identical;
+}
@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+
+typedef struct Benchmark {
+	const char *name;
+	bool (*run)();
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+	{"intersections", bench_line_intersections},
+	{"simplification", bench_simplification},
+	{"scan", bench_scan},
+};
+
+double bench_now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double) time.tv_sec + (double) time.tv_nsec * 1e-9;
+}
+
+// runs all benchmarks or only those named on the command line; fails if any result is wrong
+int main(int argc, char **argv) {
+	size_t num_benchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+	bool success = true;
+	for(size_t b = 0; b < num_benchmarks; b++) {
+		bool selected = argc < 2;
+		for(int a = 1; a < argc; a++) if(strcmp(argv[a], benchmarks[b].name) == 0) selected = true;
+		if(!selected) continue;
+
+		printf("== %s\n", benchmarks[b].name);
+		bool passed = benchmarks[b].run();
+		printf("%s\n\n", passed ? "OK" : "FAILED");
+		success = success && passed;
+	}
+	return success ? 0 : 1;
+}
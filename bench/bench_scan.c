@@ -0,0 +1,63 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "geometrylib_datatool.h"
+
+#define BENCH_SCAN_NUM_VALUES ((size_t) 32 << 20)
+#define BENCH_SCAN_NUM_PASSES 5
+#define BENCH_SCAN_NUM_GATHERS ((size_t) 16 << 20)
+
+typedef struct ScanResult {
+	double sum, gather_sum;
+} ScanResult;
+
+// fills, scans and randomly gathers a 256 MiB array allocated under the current huge-page threshold
+static ScanResult run_scan(const char *label) {
+	ScanResult result = {0, 0};
+	double start = bench_now();
+	DataArray1 *arr = data_array1_create();
+	data_array1_reserve(arr, BENCH_SCAN_NUM_VALUES);
+	for(size_t i = 0; i < BENCH_SCAN_NUM_VALUES; i++) data_array1_append_new(arr, (double) (i % 1000));
+	double fill_time = bench_now() - start;
+
+	const double *values = data_array1_get_data(arr);
+	start = bench_now();
+	for(int pass = 0; pass < BENCH_SCAN_NUM_PASSES; pass++) {
+		double sum = 0;
+		for(size_t i = 0; i < BENCH_SCAN_NUM_VALUES; i++) sum += values[i];
+		result.sum = sum;
+	}
+	double scan_time = (bench_now() - start) / BENCH_SCAN_NUM_PASSES;
+
+	// random accesses spread over the whole buffer are where TLB misses show
+	uint64_t state = 1;
+	start = bench_now();
+	for(size_t g = 0; g < BENCH_SCAN_NUM_GATHERS; g++) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		result.gather_sum += values[(state >> 16) % BENCH_SCAN_NUM_VALUES];
+	}
+	double gather_time = bench_now() - start;
+
+	double num_gib = (double) (BENCH_SCAN_NUM_VALUES * sizeof(double)) / (1 << 30);
+	printf("%-18s fill %7.4f s, scan %7.2f GiB/s, gather %7.2f M/s\n", label, fill_time,
+		num_gib / scan_time, (double) BENCH_SCAN_NUM_GATHERS / gather_time * 1e-6);
+	data_array1_free(arr);
+	return result;
+}
+
+bool bench_scan() {
+	printf("%zu values (%zu MiB), %d scan passes, %zu random gathers\n", BENCH_SCAN_NUM_VALUES,
+		BENCH_SCAN_NUM_VALUES * sizeof(double) >> 20, BENCH_SCAN_NUM_PASSES, BENCH_SCAN_NUM_GATHERS);
+
+	// the array exceeds the threshold unless it is 0 (or set above the array size by the caller)
+	size_t threshold = data_array_get_huge_page_threshold();
+	printf("huge-page threshold: %zu MiB\n", threshold >> 20);
+	ScanResult huge_pages = run_scan("current threshold");
+	data_array_set_huge_page_threshold(0);
+	ScanResult heap = run_scan("regular heap (0)");
+	data_array_set_huge_page_threshold(threshold);
+
+	// same data in the same order, so the sums have to agree exactly
+	return huge_pages.sum == heap.sum && huge_pages.gather_sum == heap.gather_sum;
+}
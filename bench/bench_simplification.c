@@ -0,0 +1,91 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "geometrylib_polyline.h"
+
+#define BENCH_SIMPLIFICATION_NUM_POINTS 1000000
+#define BENCH_SIMPLIFICATION_TOLERANCE 0.05
+
+// deterministic noise in [-0.5, 0.5) so that runs are comparable
+static double next_noise(uint64_t *state) {
+	*state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (double) (*state >> 11) / (double) (1ULL << 53) - 0.5;
+}
+
+static double segment_distance(Vector2 p, Vector2 a, Vector2 b) {
+	double dx = b.x - a.x, dy = b.y - a.y;
+	double len_sq = dx * dx + dy * dy;
+	double t = len_sq > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len_sq : 0;
+	t = t < 0 ? 0 : t > 1 ? 1 : t;
+	return hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+}
+
+// checks the guarantees of simplify_polyline2_indices; the distance bound only holds for RDP and streaming
+static bool are_indices_valid(const Vector2 *points, size_t n, const size_t *indices, size_t num_kept, bool check_distance) {
+	if(num_kept < 2 || indices[0] != 0 || indices[num_kept - 1] != n - 1) return false;
+	for(size_t k = 1; k < num_kept; k++) {
+		if(indices[k] <= indices[k - 1]) return false;
+		if(!check_distance) continue;
+		for(size_t i = indices[k - 1] + 1; i < indices[k]; i++)
+			if(segment_distance(points[i], points[indices[k - 1]], points[indices[k]]) > BENCH_SIMPLIFICATION_TOLERANCE * (1 + 1e-9)) return false;
+	}
+	return true;
+}
+
+bool bench_simplification() {
+	DataArray2 *line = data_array2_create();
+	uint64_t state = 42;
+	for(int i = 0; i < BENCH_SIMPLIFICATION_NUM_POINTS; i++) {
+		double x = i * 1e-3;
+		data_array2_append_new(line, vec2(x, sin(x) + 0.02 * next_noise(&state)));
+	}
+	size_t n = data_array2_size(line);
+	Vector2 *points = data_array2_get_data(line);
+	size_t *indices = malloc(n * sizeof(size_t));
+	bool success = true;
+
+	printf("%zu points, tolerance %g\n", n, BENCH_SIMPLIFICATION_TOLERANCE);
+	const struct {
+		const char *name;
+		PolylineSimplification method;
+	} methods[] = {
+		{"rdp", POLYLINE_SIMPLIFY_RDP},
+		{"visvalingam", POLYLINE_SIMPLIFY_VISVALINGAM},
+		{"streaming", POLYLINE_SIMPLIFY_STREAMING},
+	};
+	size_t num_streaming_kept = 0;
+	for(size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+		double start = bench_now();
+		size_t num_kept = simplify_polyline2_indices(line, BENCH_SIMPLIFICATION_TOLERANCE, methods[m].method, indices);
+		double time = bench_now() - start;
+
+		bool valid = are_indices_valid(points, n, indices, num_kept, methods[m].method != POLYLINE_SIMPLIFY_VISVALINGAM);
+		printf("%-12s %10.4f s, %8zu points kept%s\n", methods[m].name, time, num_kept, valid ? "" : " (INVALID)");
+		success = success && valid;
+		if(methods[m].method == POLYLINE_SIMPLIFY_STREAMING) num_streaming_kept = num_kept;
+	}
+
+	// the point-by-point simplifier has to match POLYLINE_SIMPLIFY_STREAMING (indices still hold its result)
+	PolylineSimplifier *simplifier = polyline_simplifier_create(BENCH_SIMPLIFICATION_TOLERANCE);
+	DataArray2 *out = data_array2_create();
+	double start = bench_now();
+	for(size_t i = 0; i < n; i++) polyline_simplifier_add2(simplifier, points[i], out);
+	polyline_simplifier_finish2(simplifier, out);
+	double time = bench_now() - start;
+
+	bool matches = data_array2_size(out) == num_streaming_kept;
+	for(size_t k = 0; matches && k < num_streaming_kept; k++)
+		matches = memcmp(&data_array2_get_data(out)[k], &points[indices[k]], sizeof(Vector2)) == 0;
+	printf("%-12s %10.4f s, %8zu points kept%s\n", "simplifier", time, data_array2_size(out), matches ? "" : " (MISMATCH)");
+	success = success && matches;
+
+	polyline_simplifier_free(simplifier);
+	data_array2_free(out);
+	data_array2_free(line);
+	free(indices);
+	return success;
+}
@@ -6,7 +6,14 @@
 #include "geometrylib_plane.h"
 #include "geometrylib_datatool.h"
 #include "geometrylib_linetool.h"
+#include "geometrylib_polyline.h"
+#include "geometrylib_spline.h"
 #include "geometrylib_calculus.h"
+#include "geometrylib_statistics.h"
+#include "geometrylib_dataio.h"
+#include "geometrylib_databin.h"
+#include "geometrylib_datastream.h"
+#include "geometrylib_datacompress.h"
 
 
 /**
@@ -35,4 +42,12 @@ double rad2deg(double rad);
  */
 double pi_norm(double rad);
 
+
+/**
+ * @brief Sets the maximum number of threads used by the parallel paths for very large arrays
+ *
+ * @param num_threads Maximum number of threads (0 = number of online CPUs (default), 1 = no multithreading)
+ */
+void geometrylib_set_num_threads(int num_threads);
+
 #endif // GEOMETRYLIB_GEOMETRYLIB_H
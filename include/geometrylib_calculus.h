@@ -47,6 +47,22 @@ double get_single_root_of_line_array(DataArray2 *arr);
  */
 double get_single_shifted_root_of_line_array(DataArray2 *arr, double y);
 
+/**
+ * @brief Finds every crossing of a 2-dimensional data array with each of several y-levels in a single pass
+ *
+ * A level l is crossed between two consecutive points when (y0 < l) != (y1 < l), so a level touched exactly
+ * at a point and left again in the same direction counts as a crossing up and a crossing down at that point.
+ * The array is scanned once: runs of points that stay between the same two levels are skipped with SIMD
+ * comparisons, and the levels crossed by a segment are found by walking from the previous band.
+ * Segments with a NaN y-value are skipped.
+ *
+ * @param arr Pointer to the 2-dimensional array of (x, y) pairs
+ * @param levels y-levels (any order; NaN levels are ignored)
+ * @param num_levels Number of levels
+ * @return Array of (x, level) pairs of all crossings, sorted by x
+ */
+DataArray2 * get_level_crossings_of_line_array(DataArray2 *arr, const double *levels, size_t num_levels);
+
 
 /*
  * ------------------------------------
@@ -106,9 +122,9 @@ int get_idx_of_unimodal_func_maximum(DataArray2 *arr);
 /**
  * @brief Returns the index of the entry that has an x smaller than the given one with the next entry being bigger
  *
- * @param arr Pointer to the 2-dimensional array of (x, y) pairs
+ * @param arr Pointer to the 2-dimensional array of (x, y) pairs (x is sorted)
  * @param x Requested x
- * @return Index of x index (floored)
+ * @return Index of x index (floored; the index of the last segment for the last x)
  */
 int get_idx_of_func_x(DataArray2 *arr, double x);
 
@@ -169,6 +185,25 @@ double max_achievable_value_from_prev_and_next_points(DataArray2 *arr, int max_i
  * ------------------------------------
  */
 
+/**
+ * @brief Function evaluated by the root-finding driver
+ *
+ * @param x x-value to evaluate the function at
+ * @param ctx User context passed to the driver
+ * @return Function value at x
+ */
+typedef double (*RootFunction)(double x, void *ctx);
+
+/**
+ * @brief Result of find_root_of_monot_func
+ */
+typedef struct RootFinderResult {
+	double root;			/**< Root estimate (NAN if the bracket does not contain a sign change) */
+	size_t num_evaluations;	/**< Number of function evaluations (including the two at the bracket) */
+	bool converged;			/**< The tolerances were reached within the evaluation budget */
+} RootFinderResult;
+
+
 /**
  * @brief Returns the next x-value to evaluate during root-finding of a monotonic function
  *
@@ -182,6 +217,28 @@ double max_achievable_value_from_prev_and_next_points(DataArray2 *arr, int max_i
  */
 double root_finder_monot_func_next_x(DataArray2 *arr, double min_diff_ratio, double min_dx);
 
+/**
+ * @brief Finds the root of a monotonic function in a bracket by repeatedly evaluating it at root_finder_monot_func_next_x
+ *
+ * The search stops once |f(x)| <= y_tol, once the bracket around the sign change is not wider than x_tol
+ * (the root is then interpolated inside it) or once max_evaluations evaluations have been spent.
+ * The evaluated points are kept in work (sorted by x), whose memory is reused: after a first search with the
+ * same budget, further searches do not allocate.
+ *
+ * @param func Function to find the root of
+ * @param ctx User context passed to func
+ * @param x0 Lower end of the bracket
+ * @param x1 Upper end of the bracket
+ * @param min_diff_ratio The minimum distance to the next point as a ratio of the difference in x between points
+ * @param x_tol Width of the bracket at which the search has converged
+ * @param y_tol Absolute function value at which the search has converged (0 to only use x_tol)
+ * @param max_evaluations Maximum number of function evaluations (at least 2)
+ * @param work Pointer to the 2-dimensional array that receives the evaluated points (cleared first; NULL for a temporary one)
+ * @return Root estimate, number of evaluations and whether the search converged
+ */
+RootFinderResult find_root_of_monot_func(RootFunction func, void *ctx, double x0, double x1, double min_diff_ratio,
+										 double x_tol, double y_tol, size_t max_evaluations, DataArray2 *work);
+
 /**
  * @brief Returns the next x-value to evaluate during root-finding of a function with monotonic derivative
  *
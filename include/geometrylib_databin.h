@@ -0,0 +1,217 @@
+#ifndef KMAT_GEOMETRYLIB_DATABIN_H
+#define KMAT_GEOMETRYLIB_DATABIN_H
+
+#include "geometrylib_datatool.h"
+
+
+/*
+ * ------------------------------------
+ * Structures
+ * ------------------------------------
+ */
+
+/**
+ * @brief Type of array stored in a binary array file
+ */
+typedef enum DataArrayType {
+	DATA_ARRAY_TYPE_1 = 1,	/**< DataArray1 */
+	DATA_ARRAY_TYPE_2 = 2,	/**< DataArray2 */
+	DATA_ARRAY_TYPE_3 = 3,	/**< DataArray3 */
+	DATA_ARRAY_TYPE_N = 4	/**< DataArrayN */
+} DataArrayType;
+
+/**
+ * @brief Header information of a binary array file
+ */
+typedef struct DataArrayFileInfo {
+	DataArrayType type;	/**< Type of the stored array */
+	int dimensions;		/**< Number of doubles per element */
+	size_t count;		/**< Number of elements */
+	bool sorted;		/**< Elements are sorted in ascending order (first x, then y, then z; first dimension for DataArrayN) */
+	size_t data_offset;	/**< Byte offset of the first element in the file */
+} DataArrayFileInfo;
+
+
+/*
+ * ------------------------------------
+ * Binary Files
+ * ------------------------------------
+ */
+
+/**
+ * @brief Reads the header of a binary array file
+ *
+ * The file consists of a 64-byte header followed by the raw elements in native byte order.
+ *
+ * @param path Path to the file
+ * @param info Output for the header information
+ * @return False if the file could not be read or is not a binary array file
+ */
+bool data_array_file_get_info(const char *path, DataArrayFileInfo *info);
+
+/**
+ * @brief Saves a 1-dimensional array to a binary array file
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_array1_save(DataArray1 *arr, const char *path);
+
+/**
+ * @brief Saves a 2-dimensional array to a binary array file
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_array2_save(DataArray2 *arr, const char *path);
+
+/**
+ * @brief Saves a 3-dimensional array to a binary array file
+ *
+ * @param arr Pointer to the 3-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_array3_save(DataArray3 *arr, const char *path);
+
+/**
+ * @brief Saves an N-dimensional array to a binary array file
+ *
+ * @param arr Pointer to the N-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_arrayn_save(DataArrayN *arr, const char *path);
+
+/**
+ * @brief Loads a 1-dimensional array from a binary array file without copying
+ *
+ * The file is memory-mapped read-only and the array points into the mapping, so opening is O(1).
+ * Do not write through data_array1_get_data; appending, inserting and removing first move the data into own memory.
+ * The mapping is released when the array is freed or cleared.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or holds another array type)
+ */
+DataArray1 * data_array1_load(const char *path);
+
+/**
+ * @brief Loads a 2-dimensional array from a binary array file without copying
+ *
+ * See data_array1_load.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or holds another array type)
+ */
+DataArray2 * data_array2_load(const char *path);
+
+/**
+ * @brief Loads a 3-dimensional array from a binary array file without copying
+ *
+ * See data_array1_load.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or holds another array type)
+ */
+DataArray3 * data_array3_load(const char *path);
+
+/**
+ * @brief Loads an N-dimensional array from a binary array file
+ *
+ * DataArrayN stores each element separately, so its elements are copied out of the file mapping.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or holds another array type)
+ */
+DataArrayN * data_arrayn_load(const char *path);
+
+
+/*
+ * ------------------------------------
+ * NumPy Files
+ * ------------------------------------
+ */
+
+/**
+ * @brief Saves a 1-dimensional array as NumPy .npy file (float64, shape (n,))
+ *
+ * The data starts 64-byte aligned, so numpy.load(path, mmap_mode='r') maps it without parsing.
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_array1_save_npy(DataArray1 *arr, const char *path);
+
+/**
+ * @brief Saves a 2-dimensional array as NumPy .npy file (float64, shape (n, 2))
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_array2_save_npy(DataArray2 *arr, const char *path);
+
+/**
+ * @brief Saves a 3-dimensional array as NumPy .npy file (float64, shape (n, 3))
+ *
+ * @param arr Pointer to the 3-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_array3_save_npy(DataArray3 *arr, const char *path);
+
+/**
+ * @brief Saves an N-dimensional array as NumPy .npy file (float64, shape (n, dimensions))
+ *
+ * @param arr Pointer to the N-dimensional array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool data_arrayn_save_npy(DataArrayN *arr, const char *path);
+
+/**
+ * @brief Loads a 1-dimensional array from a NumPy .npy file of shape (n,) or (n, 1)
+ *
+ * Float64 data in native byte order is used in place from a read-only file mapping (as data_array1_load).
+ * Other byte orders and float32, int64 and int32 data are converted into own memory.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or has another shape or data type)
+ */
+DataArray1 * data_array1_load_npy(const char *path);
+
+/**
+ * @brief Loads a 2-dimensional array from a NumPy .npy file of shape (n, 2)
+ *
+ * C-ordered float64 data in native byte order is used in place from a read-only file mapping (as data_array2_load).
+ * Fortran order, other byte orders and float32, int64 and int32 data are converted into own memory.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or has another shape or data type)
+ */
+DataArray2 * data_array2_load_npy(const char *path);
+
+/**
+ * @brief Loads a 3-dimensional array from a NumPy .npy file of shape (n, 3)
+ *
+ * See data_array2_load_npy.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or has another shape or data type)
+ */
+DataArray3 * data_array3_load_npy(const char *path);
+
+/**
+ * @brief Loads an N-dimensional array from a NumPy .npy file of shape (n, dimensions) or (n,)
+ *
+ * The elements are always copied (see data_arrayn_load); float32, int64 and int32 data are converted.
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded array (NULL if the file could not be read or has another data type)
+ */
+DataArrayN * data_arrayn_load_npy(const char *path);
+
+#endif //KMAT_GEOMETRYLIB_DATABIN_H
@@ -0,0 +1,152 @@
+#ifndef KMAT_GEOMETRYLIB_DATACOMPRESS_H
+#define KMAT_GEOMETRYLIB_DATACOMPRESS_H
+
+#include "geometrylib_datatool.h"
+
+
+/*
+ * ------------------------------------
+ * Structures
+ * ------------------------------------
+ */
+
+/**
+ * @brief Read-only, losslessly compressed 2-dimensional array (e.g. a sampled time series)
+ *
+ * Elements are stored in independently decodable blocks (Gorilla encoding): x as delta-of-delta
+ * of its bit pattern, y as XOR with the previous y. Sorted, mostly uniform x and smooth y compress best.
+ * The first and last x of every block are kept uncompressed for binary searches.
+ */
+typedef struct CompressedDataArray2 CompressedDataArray2;
+
+
+/*
+ * ------------------------------------
+ * Create and Free
+ * ------------------------------------
+ */
+
+/**
+ * @brief Compresses a 2-dimensional array (the array stays unchanged)
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @param block_size Number of elements per block (0 for a default of 1024)
+ * @return Pointer to the newly allocated compressed array (NULL if arr is NULL)
+ */
+CompressedDataArray2 * compressed_data_array2_create(DataArray2 *arr, size_t block_size);
+
+/**
+ * @brief Frees a compressed array
+ *
+ * @param carr Pointer to the compressed array
+ */
+void compressed_data_array2_free(CompressedDataArray2 *carr);
+
+
+/*
+ * ------------------------------------
+ * Properties
+ * ------------------------------------
+ */
+
+/**
+ * @brief Returns the number of elements of a compressed array
+ *
+ * @param carr Pointer to the compressed array
+ * @return Number of elements
+ */
+size_t compressed_data_array2_size(CompressedDataArray2 *carr);
+
+/**
+ * @brief Returns the number of blocks of a compressed array
+ *
+ * @param carr Pointer to the compressed array
+ * @return Number of blocks
+ */
+size_t compressed_data_array2_num_blocks(CompressedDataArray2 *carr);
+
+/**
+ * @brief Returns the number of bytes of the compressed data (without the block index)
+ *
+ * @param carr Pointer to the compressed array
+ * @return Number of bytes (compare to size * sizeof(Vector2))
+ */
+size_t compressed_data_array2_num_bytes(CompressedDataArray2 *carr);
+
+
+/*
+ * ------------------------------------
+ * Decompression and Access
+ * ------------------------------------
+ */
+
+/**
+ * @brief Decompresses the whole array (blocks are decoded on multiple threads for very large arrays)
+ *
+ * @param carr Pointer to the compressed array
+ * @return Pointer to the newly allocated 2-dimensional array
+ */
+DataArray2 * compressed_data_array2_decompress(CompressedDataArray2 *carr);
+
+/**
+ * @brief Decompresses one block into an array (replacing its elements; its memory is reused for scans)
+ *
+ * @param carr Pointer to the compressed array
+ * @param block_idx Index of the block
+ * @param dst Pointer to the 2-dimensional array that receives the elements of the block
+ * @return Number of decoded elements (0 if block_idx is out of range)
+ */
+size_t compressed_data_array2_decompress_block(CompressedDataArray2 *carr, size_t block_idx, DataArray2 *dst);
+
+/**
+ * @brief Returns an element of a compressed array (decodes its block up to the element)
+ *
+ * @param carr Pointer to the compressed array
+ * @param idx Index of the element
+ * @return Element (NAN components if idx is out of range)
+ */
+Vector2 compressed_data_array2_get(CompressedDataArray2 *carr, size_t idx);
+
+/**
+ * @brief Finds the block that contains a given x-value by binary search over the block index (x is sorted)
+ *
+ * @param carr Pointer to the compressed array
+ * @param x x-value
+ * @return Index of the last block whose first x is not larger than x (-1 if x is outside of the array's x-range)
+ */
+int compressed_data_array2_find_block(CompressedDataArray2 *carr, double x);
+
+/**
+ * @brief Returns the interpolated y-value to a given x-value (x is sorted), decoding only a single block
+ *
+ * @param carr Pointer to the compressed array
+ * @param x x-value for which the y-value is to be interpolated
+ * @return Interpolated y-value (NAN if x is outside of the array's x-range)
+ */
+double compressed_data_array2_interpolate(CompressedDataArray2 *carr, double x);
+
+
+/*
+ * ------------------------------------
+ * Files
+ * ------------------------------------
+ */
+
+/**
+ * @brief Saves a compressed array to a file
+ *
+ * @param carr Pointer to the compressed array
+ * @param path Path to the file (gets overwritten)
+ * @return False if the file could not be written
+ */
+bool compressed_data_array2_save(CompressedDataArray2 *carr, const char *path);
+
+/**
+ * @brief Loads a compressed array from a file written by compressed_data_array2_save
+ *
+ * @param path Path to the file
+ * @return Pointer to the loaded compressed array (NULL if the file could not be read or is invalid)
+ */
+CompressedDataArray2 * compressed_data_array2_load(const char *path);
+
+#endif //KMAT_GEOMETRYLIB_DATACOMPRESS_H
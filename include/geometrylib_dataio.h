@@ -0,0 +1,238 @@
+#ifndef KMAT_GEOMETRYLIB_DATAIO_H
+#define KMAT_GEOMETRYLIB_DATAIO_H
+
+#include "geometrylib_datatool.h"
+#include <stdio.h>
+
+
+/*
+ * ------------------------------------
+ * Structures
+ * ------------------------------------
+ */
+
+/**
+ * @brief Text layouts for writing arrays
+ */
+typedef enum DataTextLayout {
+	DATA_TEXT_PYTHON_LIST,	/**< One Python list per component (e.g. "x = [1, 2]"), as print_data_array* */
+	DATA_TEXT_CSV			/**< One comma separated row per element with an optional header row of names */
+} DataTextLayout;
+
+/**
+ * @brief Buffered text writer to a FILE*, a file descriptor or a growing memory buffer
+ */
+typedef struct DataTextWriter DataTextWriter;
+
+
+/*
+ * ------------------------------------
+ * Number Formatting
+ * ------------------------------------
+ */
+
+/**
+ * @brief Writes the shortest decimal representation of a double that parses back to the same value
+ *
+ * Uses Grisu2, which gives the shortest digits for all but very few values (those get one digit more)
+ * and always round-trips. Formatting follows %g (e.g. "0.1", "1e+300", "nan").
+ *
+ * @param value Value to format
+ * @param buffer Output buffer (at least 32 chars; gets null-terminated)
+ * @return Number of characters written (without null-terminator)
+ */
+int format_double_shortest(double value, char *buffer);
+
+
+/*
+ * ------------------------------------
+ * Writer
+ * ------------------------------------
+ */
+
+/**
+ * @brief Creates a text writer that writes to a FILE* (the file is not closed by the writer)
+ *
+ * @param file Output file
+ * @return Pointer to the newly allocated writer
+ */
+DataTextWriter * data_text_writer_create_file(FILE *file);
+
+/**
+ * @brief Creates a text writer that writes to a file descriptor (the descriptor is not closed by the writer)
+ *
+ * @param fd Output file descriptor
+ * @return Pointer to the newly allocated writer
+ */
+DataTextWriter * data_text_writer_create_fd(int fd);
+
+/**
+ * @brief Creates a text writer that writes into a growing memory buffer
+ *
+ * @return Pointer to the newly allocated writer
+ */
+DataTextWriter * data_text_writer_create_memory();
+
+/**
+ * @brief Returns the text written to a memory writer so far
+ *
+ * @param writer Pointer to the memory writer
+ * @param length Output for the number of characters (may be NULL)
+ * @return Null-terminated text (owned by the writer; NULL if not a memory writer)
+ */
+const char * data_text_writer_get_memory(DataTextWriter *writer, size_t *length);
+
+/**
+ * @brief Writes buffered text to the file or file descriptor
+ *
+ * @param writer Pointer to the writer
+ * @return False if any write of the writer has failed so far
+ */
+bool data_text_writer_flush(DataTextWriter *writer);
+
+/**
+ * @brief Flushes and frees a writer
+ *
+ * @param writer Pointer to the writer
+ * @return False if any write of the writer has failed
+ */
+bool data_text_writer_free(DataTextWriter *writer);
+
+
+/*
+ * ------------------------------------
+ * Write Arrays
+ * ------------------------------------
+ */
+
+/**
+ * @brief Writes a 1-dimensional array as text
+ *
+ * Very large arrays are formatted on multiple threads.
+ *
+ * @param writer Pointer to the writer
+ * @param arr Pointer to the 1-dimensional array
+ * @param layout Text layout
+ * @param names Array of 1 name (for the Python list or the CSV header; NULL for "x" and no CSV header)
+ * @return False if writing failed
+ */
+bool data_array1_write_text(DataTextWriter *writer, DataArray1 *arr, DataTextLayout layout, const char **names);
+
+/**
+ * @brief Writes a 2-dimensional array as text
+ *
+ * Very large arrays are formatted on multiple threads.
+ *
+ * @param writer Pointer to the writer
+ * @param arr Pointer to the 2-dimensional array
+ * @param layout Text layout
+ * @param names Array of 2 names (for the Python lists or the CSV header; NULL for "x", "y" and no CSV header)
+ * @return False if writing failed
+ */
+bool data_array2_write_text(DataTextWriter *writer, DataArray2 *arr, DataTextLayout layout, const char **names);
+
+/**
+ * @brief Writes a 3-dimensional array as text
+ *
+ * Very large arrays are formatted on multiple threads.
+ *
+ * @param writer Pointer to the writer
+ * @param arr Pointer to the 3-dimensional array
+ * @param layout Text layout
+ * @param names Array of 3 names (for the Python lists or the CSV header; NULL for "x", "y", "z" and no CSV header)
+ * @return False if writing failed
+ */
+bool data_array3_write_text(DataTextWriter *writer, DataArray3 *arr, DataTextLayout layout, const char **names);
+
+/**
+ * @brief Writes an N-dimensional array as text
+ *
+ * Very large arrays are formatted on multiple threads.
+ *
+ * @param writer Pointer to the writer
+ * @param arr Pointer to the N-dimensional array
+ * @param layout Text layout
+ * @param names Array of one name per dimension (for the Python lists or the CSV header; NULL for "x0", "x1", ... and no CSV header)
+ * @return False if writing failed
+ */
+bool data_arrayn_write_text(DataTextWriter *writer, DataArrayN *arr, DataTextLayout layout, const char **names);
+
+
+/*
+ * ------------------------------------
+ * Read Arrays
+ * ------------------------------------
+ */
+
+/*
+ * Text input: one element per line, values separated by whitespace and/or the delimiter.
+ * Empty lines and lines starting with '#' are skipped, columns beyond the needed ones are ignored.
+ * Large inputs are parsed on multiple threads; files are memory-mapped.
+ */
+
+/**
+ * @brief Parses delimited numeric text into a 2-dimensional array (first two columns)
+ *
+ * @param text Text to parse (does not need to be null-terminated)
+ * @param length Number of characters
+ * @param delimiter Column delimiter (e.g. ',' or ';'; ' ' for whitespace only)
+ * @param skip_rows Number of leading lines to skip (e.g. 1 for a header row)
+ * @return Pointer to the newly allocated array (NULL if a line can not be parsed)
+ */
+DataArray2 * data_array2_parse_text(const char *text, size_t length, char delimiter, int skip_rows);
+
+/**
+ * @brief Parses delimited numeric text into a 3-dimensional array (first three columns)
+ *
+ * @param text Text to parse (does not need to be null-terminated)
+ * @param length Number of characters
+ * @param delimiter Column delimiter (e.g. ',' or ';'; ' ' for whitespace only)
+ * @param skip_rows Number of leading lines to skip (e.g. 1 for a header row)
+ * @return Pointer to the newly allocated array (NULL if a line can not be parsed)
+ */
+DataArray3 * data_array3_parse_text(const char *text, size_t length, char delimiter, int skip_rows);
+
+/**
+ * @brief Parses delimited numeric text into an N-dimensional array
+ *
+ * @param text Text to parse (does not need to be null-terminated)
+ * @param length Number of characters
+ * @param dimensions Number of columns to read (0 to use the number of columns of the first data line)
+ * @param delimiter Column delimiter (e.g. ',' or ';'; ' ' for whitespace only)
+ * @param skip_rows Number of leading lines to skip (e.g. 1 for a header row)
+ * @return Pointer to the newly allocated array (NULL if a line can not be parsed or no columns were found)
+ */
+DataArrayN * data_arrayn_parse_text(const char *text, size_t length, int dimensions, char delimiter, int skip_rows);
+
+/**
+ * @brief Reads a delimited numeric text file (e.g. CSV) into a 2-dimensional array (first two columns)
+ *
+ * @param path Path of the file
+ * @param delimiter Column delimiter (e.g. ',' or ';'; ' ' for whitespace only)
+ * @param skip_rows Number of leading lines to skip (e.g. 1 for a header row)
+ * @return Pointer to the newly allocated array (NULL if the file can not be read, is empty or a line can not be parsed)
+ */
+DataArray2 * data_array2_read_text_file(const char *path, char delimiter, int skip_rows);
+
+/**
+ * @brief Reads a delimited numeric text file (e.g. CSV) into a 3-dimensional array (first three columns)
+ *
+ * @param path Path of the file
+ * @param delimiter Column delimiter (e.g. ',' or ';'; ' ' for whitespace only)
+ * @param skip_rows Number of leading lines to skip (e.g. 1 for a header row)
+ * @return Pointer to the newly allocated array (NULL if the file can not be read, is empty or a line can not be parsed)
+ */
+DataArray3 * data_array3_read_text_file(const char *path, char delimiter, int skip_rows);
+
+/**
+ * @brief Reads a delimited numeric text file (e.g. CSV) into an N-dimensional array
+ *
+ * @param path Path of the file
+ * @param dimensions Number of columns to read (0 to use the number of columns of the first data line)
+ * @param delimiter Column delimiter (e.g. ',' or ';'; ' ' for whitespace only)
+ * @param skip_rows Number of leading lines to skip (e.g. 1 for a header row)
+ * @return Pointer to the newly allocated array (NULL if the file can not be read, is empty or a line can not be parsed)
+ */
+DataArrayN * data_arrayn_read_text_file(const char *path, int dimensions, char delimiter, int skip_rows);
+
+#endif //KMAT_GEOMETRYLIB_DATAIO_H
@@ -0,0 +1,251 @@
+#ifndef KMAT_GEOMETRYLIB_DATASTREAM_H
+#define KMAT_GEOMETRYLIB_DATASTREAM_H
+
+#include "geometrylib_datatool.h"
+#include "geometrylib_databin.h"
+
+
+/*
+ * ------------------------------------
+ * Structures
+ * ------------------------------------
+ */
+
+/**
+ * @brief Reads a binary array file (DataArray1/2/3) chunk by chunk with bounded memory
+ */
+typedef struct DataArrayStream DataArrayStream;
+
+/**
+ * @brief Appends chunks to a binary array file (DataArray1/2/3) without holding the whole array in memory
+ */
+typedef struct DataArrayStreamWriter DataArrayStreamWriter;
+
+/**
+ * @brief State carried across chunk boundaries by the chunk functions (zero-initialize before the first chunk)
+ */
+typedef struct DataChunkState {
+	bool has_last;	/**< A previous chunk contained elements */
+	Vector2 last;	/**< Last element of the previous chunks (only x is used for DataArray1) */
+} DataChunkState;
+
+
+/*
+ * ------------------------------------
+ * Reading
+ * ------------------------------------
+ */
+
+/**
+ * @brief Opens a binary array file (see data_array1_save) for reading it in chunks
+ *
+ * @param path Path to the file
+ * @param chunk_size Maximum number of elements per chunk (0 for a default of 65536)
+ * @return Pointer to the newly allocated stream (NULL if the file could not be read or holds a DataArrayN)
+ */
+DataArrayStream * data_array_stream_open(const char *path, size_t chunk_size);
+
+/**
+ * @brief Closes a stream and frees its chunk buffer
+ *
+ * @param stream Pointer to the stream
+ */
+void data_array_stream_close(DataArrayStream *stream);
+
+/**
+ * @brief Returns the header information of the file of a stream
+ *
+ * @param stream Pointer to the stream
+ * @return Header information
+ */
+DataArrayFileInfo data_array_stream_get_info(DataArrayStream *stream);
+
+/**
+ * @brief Moves a stream back to the first element
+ *
+ * @param stream Pointer to the stream
+ */
+void data_array_stream_rewind(DataArrayStream *stream);
+
+/**
+ * @brief Reads the next chunk of a stream of a 1-dimensional array
+ *
+ * The returned array is owned by the stream and gets overwritten by the next call.
+ *
+ * @param stream Pointer to the stream
+ * @return Array view of the next chunk (NULL at the end of the file, on read errors or if the file holds another array type)
+ */
+DataArray1 * data_array1_stream_next(DataArrayStream *stream);
+
+/**
+ * @brief Reads the next chunk of a stream of a 2-dimensional array
+ *
+ * The returned array is owned by the stream and gets overwritten by the next call.
+ *
+ * @param stream Pointer to the stream
+ * @return Array view of the next chunk (NULL at the end of the file, on read errors or if the file holds another array type)
+ */
+DataArray2 * data_array2_stream_next(DataArrayStream *stream);
+
+/**
+ * @brief Reads the next chunk of a stream of a 3-dimensional array
+ *
+ * The returned array is owned by the stream and gets overwritten by the next call.
+ *
+ * @param stream Pointer to the stream
+ * @return Array view of the next chunk (NULL at the end of the file, on read errors or if the file holds another array type)
+ */
+DataArray3 * data_array3_stream_next(DataArrayStream *stream);
+
+
+/*
+ * ------------------------------------
+ * Writing
+ * ------------------------------------
+ */
+
+/**
+ * @brief Creates a binary array file that chunks can be appended to
+ *
+ * @param path Path to the file (gets overwritten)
+ * @param type Type of the array (DATA_ARRAY_TYPE_1, _2 or _3)
+ * @return Pointer to the newly allocated writer (NULL if the file could not be created or the type is DATA_ARRAY_TYPE_N)
+ */
+DataArrayStreamWriter * data_array_stream_writer_create(const char *path, DataArrayType type);
+
+/**
+ * @brief Appends all elements of a 1-dimensional array to the file of a writer
+ *
+ * @param writer Pointer to the writer
+ * @param chunk Pointer to the 1-dimensional array
+ * @return False if the file holds another array type or writing failed
+ */
+bool data_array1_stream_writer_append(DataArrayStreamWriter *writer, DataArray1 *chunk);
+
+/**
+ * @brief Appends all elements of a 2-dimensional array to the file of a writer
+ *
+ * @param writer Pointer to the writer
+ * @param chunk Pointer to the 2-dimensional array
+ * @return False if the file holds another array type or writing failed
+ */
+bool data_array2_stream_writer_append(DataArrayStreamWriter *writer, DataArray2 *chunk);
+
+/**
+ * @brief Appends all elements of a 3-dimensional array to the file of a writer
+ *
+ * @param writer Pointer to the writer
+ * @param chunk Pointer to the 3-dimensional array
+ * @return False if the file holds another array type or writing failed
+ */
+bool data_array3_stream_writer_append(DataArrayStreamWriter *writer, DataArray3 *chunk);
+
+/**
+ * @brief Completes the header of the file (element count, sorted flag) and frees the writer
+ *
+ * @param writer Pointer to the writer
+ * @return False if any write of the writer has failed
+ */
+bool data_array_stream_writer_close(DataArrayStreamWriter *writer);
+
+
+/*
+ * ------------------------------------
+ * Chunk Functions
+ * ------------------------------------
+ */
+
+/**
+ * @brief Appends the differences of consecutive elements of a chunk to diff, including the one to the previous chunk
+ *
+ * Feeding all chunks of an array gives the same values as data_array1_get_diff.
+ *
+ * @param chunk Pointer to the 1-dimensional chunk
+ * @param state State carried across chunks
+ * @param diff Pointer to the 1-dimensional array the differences are appended to
+ */
+void data_array1_get_diff_chunk(DataArray1 *chunk, DataChunkState *state, DataArray1 *diff);
+
+/**
+ * @brief Appends the gradients between consecutive elements of a chunk to gradient, including the one to the previous chunk
+ *
+ * Feeding all chunks of an array gives the same values as data_array2_get_gradient.
+ *
+ * @param chunk Pointer to the 2-dimensional chunk
+ * @param state State carried across chunks
+ * @param gradient Pointer to the 2-dimensional array the gradients are appended to
+ */
+void data_array2_get_gradient_chunk(DataArray2 *chunk, DataChunkState *state, DataArray2 *gradient);
+
+
+/*
+ * ------------------------------------
+ * Stream Functions
+ * ------------------------------------
+ */
+
+/**
+ * @brief Returns the minimum and maximum of a 1-dimensional array file in one pass over all chunks
+ *
+ * The stream is rewound before and read to its end.
+ *
+ * @param stream Pointer to the stream of a 1-dimensional array
+ * @return Minimum and maximum (NAN if the array is empty)
+ */
+DataBounds1 data_array1_stream_get_minmax(DataArrayStream *stream);
+
+/**
+ * @brief Returns the component-wise minimum and maximum (as data_array2_get_min/_get_max) of a 2-dimensional array file
+ *
+ * The stream is rewound before and read to its end.
+ *
+ * @param stream Pointer to the stream of a 2-dimensional array
+ * @return Bounds (NAN if the array is empty)
+ */
+DataBounds2 data_array2_stream_get_bounds(DataArrayStream *stream);
+
+/**
+ * @brief Returns the component-wise minimum and maximum (as data_array3_get_min/_get_max) of a 3-dimensional array file
+ *
+ * The stream is rewound before and read to its end.
+ *
+ * @param stream Pointer to the stream of a 3-dimensional array
+ * @return Bounds (NAN if the array is empty)
+ */
+DataBounds3 data_array3_stream_get_bounds(DataArrayStream *stream);
+
+/**
+ * @brief Writes the differences of consecutive elements of a 1-dimensional array file to a new binary array file
+ *
+ * The stream is rewound before and read to its end.
+ *
+ * @param stream Pointer to the stream of a 1-dimensional array
+ * @param path Path of the output file (gets overwritten)
+ * @return False if reading or writing failed
+ */
+bool data_array1_stream_get_diff(DataArrayStream *stream, const char *path);
+
+/**
+ * @brief Writes the gradients between consecutive elements of a 2-dimensional array file to a new binary array file
+ *
+ * The stream is rewound before and read to its end.
+ *
+ * @param stream Pointer to the stream of a 2-dimensional array
+ * @param path Path of the output file (gets overwritten)
+ * @return False if reading or writing failed
+ */
+bool data_array2_stream_get_gradient(DataArrayStream *stream, const char *path);
+
+/**
+ * @brief Returns all intersections between two line array files with a single merge sweep over both
+ *
+ * Only segments whose x-ranges overlap are tested, which requires both lines to be sorted by x.
+ * Both streams are rewound before and read to their end.
+ *
+ * @param line0 Pointer to the stream of the first 2-dimensional array of (x, y) pairs (x is sorted)
+ * @param line1 Pointer to the stream of the second 2-dimensional array of (x, y) pairs (x is sorted)
+ * @return Array of intersections
+ */
+DataArray2 * get_line_intersections_stream(DataArrayStream *line0, DataArrayStream *line1);
+
+#endif //KMAT_GEOMETRYLIB_DATASTREAM_H
@@ -31,6 +31,30 @@ typedef struct DataArray3 DataArray3;
  */
 typedef struct DataArrayN DataArrayN;
 
+/**
+ * @brief Minimum and maximum value of a 1-dimensional array
+ */
+typedef struct DataBounds1 {
+	double min; /**< Minimum value */
+	double max; /**< Maximum value */
+} DataBounds1;
+
+/**
+ * @brief Component-wise minimum and maximum (axis-aligned bounding box) of a 2-dimensional array
+ */
+typedef struct DataBounds2 {
+	Vector2 min; /**< Component-wise minimum */
+	Vector2 max; /**< Component-wise maximum */
+} DataBounds2;
+
+/**
+ * @brief Component-wise minimum and maximum (axis-aligned bounding box) of a 3-dimensional array
+ */
+typedef struct DataBounds3 {
+	Vector3 min; /**< Component-wise minimum */
+	Vector3 max; /**< Component-wise maximum */
+} DataBounds3;
+
 
 /*
  * ------------------------------------
@@ -219,6 +243,44 @@ size_t data_arrayn_size(DataArrayN *arr);
  */
 size_t data_arrayn_num_dimensions(DataArrayN *arr);
 
+/*
+ * ------------------------------------
+ * Capacity
+ * ------------------------------------
+ */
+
+/**
+ * @brief Makes sure a 1-dimensional array can hold at least capacity elements without reallocating
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @param capacity Minimum number of elements
+ */
+void data_array1_reserve(DataArray1 *arr, size_t capacity);
+
+/**
+ * @brief Makes sure a 2-dimensional array can hold at least capacity elements without reallocating
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @param capacity Minimum number of elements
+ */
+void data_array2_reserve(DataArray2 *arr, size_t capacity);
+
+/**
+ * @brief Makes sure a 3-dimensional array can hold at least capacity elements without reallocating
+ *
+ * @param arr Pointer to the 3-dimensional array
+ * @param capacity Minimum number of elements
+ */
+void data_array3_reserve(DataArray3 *arr, size_t capacity);
+
+/**
+ * @brief Makes sure an N-dimensional array can hold at least capacity elements without reallocating
+ *
+ * @param arr Pointer to the N-dimensional array
+ * @param capacity Minimum number of elements
+ */
+void data_arrayn_reserve(DataArrayN *arr, size_t capacity);
+
 /*
  * ------------------------------------
  * Get Data
@@ -589,4 +651,304 @@ Vector3 data_array3_get_max(DataArray3 *arr);
  */
 Vector3 data_array3_get_min(DataArray3 *arr);
 
+/**
+ * @brief Returns the minimum and maximum value in a 1-dimensional array in a single pass
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @return Minimum and maximum value, or NAN for both if the array is NULL or empty
+ */
+DataBounds1 data_array1_get_minmax(DataArray1 *arr);
+
+/**
+ * @brief Returns the component-wise minimum and maximum vector (bounding box) of a 2-dimensional array in a single pass
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @return Bounding box, or vec2(NAN, NAN) for min and max if the array is NULL or empty
+ */
+DataBounds2 data_array2_get_bounds(DataArray2 *arr);
+
+/**
+ * @brief Returns the component-wise minimum and maximum vector (bounding box) of a 3-dimensional array in a single pass
+ *
+ * @param arr Pointer to the 3-dimensional array
+ * @return Bounding box, or vec3(NAN, NAN, NAN) for min and max if the array is NULL or empty
+ */
+DataBounds3 data_array3_get_bounds(DataArray3 *arr);
+
+/**
+ * @brief Determines the indices of the minimum and maximum value in a 1-dimensional array in a single pass
+ *
+ * The first occurrence is returned for repeated values.
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @param min_idx Output for the index of the minimum (-1 if the array is NULL or empty; may be NULL)
+ * @param max_idx Output for the index of the maximum (-1 if the array is NULL or empty; may be NULL)
+ */
+void data_array1_get_minmax_idx(DataArray1 *arr, int *min_idx, int *max_idx);
+
+/**
+ * @brief Determines the indices of the minimum and maximum of one component in a 2-dimensional array in a single pass
+ *
+ * The first occurrence is returned for repeated values.
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @param component Component to compare (0 = x, 1 = y)
+ * @param min_idx Output for the index of the minimum (-1 if the array is NULL or empty; may be NULL)
+ * @param max_idx Output for the index of the maximum (-1 if the array is NULL or empty; may be NULL)
+ */
+void data_array2_get_minmax_idx(DataArray2 *arr, int component, int *min_idx, int *max_idx);
+
+/**
+ * @brief Determines the indices of the minimum and maximum of one component in a 3-dimensional array in a single pass
+ *
+ * The first occurrence is returned for repeated values.
+ *
+ * @param arr Pointer to the 3-dimensional array
+ * @param component Component to compare (0 = x, 1 = y, 2 = z)
+ * @param min_idx Output for the index of the minimum (-1 if the array is NULL or empty; may be NULL)
+ * @param max_idx Output for the index of the maximum (-1 if the array is NULL or empty; may be NULL)
+ */
+void data_array3_get_minmax_idx(DataArray3 *arr, int component, int *min_idx, int *max_idx);
+
+
+/*
+* ------------------------------------
+* Sum and Cached Aggregates
+* ------------------------------------
+*/
+
+/**
+ * @brief Returns the sum of all values in a 1-dimensional array
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @return Sum of all values (0 if the array is NULL or empty)
+ */
+double data_array1_get_sum(DataArray1 *arr);
+
+/**
+ * @brief Returns the component-wise sum of all vectors in a 2-dimensional array
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @return Sum of all vectors (vec2(0, 0) if the array is NULL or empty)
+ */
+Vector2 data_array2_get_sum(DataArray2 *arr);
+
+/**
+ * @brief Returns the component-wise sum of all vectors in a 3-dimensional array
+ *
+ * @param arr Pointer to the 3-dimensional array
+ * @return Sum of all vectors (vec3(0, 0, 0) if the array is NULL or empty)
+ */
+Vector3 data_array3_get_sum(DataArray3 *arr);
+
+/**
+ * @brief Enables or disables cached aggregates (min, max, sum) for a 1-dimensional array
+ *
+ * While enabled, the aggregates are updated in O(1) on append and insert. Removing an element
+ * invalidates them if it was on the boundary, and the next getter recomputes them once.
+ * data_array1_get_min, _get_max, _get_minmax and _get_sum are O(1) in steady state.
+ * If the data is modified directly through data_array1_get_data, call data_array1_invalidate_cache afterwards.
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @param enable True to enable, false to disable
+ */
+void data_array1_enable_aggregates(DataArray1 *arr, bool enable);
+
+/**
+ * @brief Enables or disables cached aggregates (bounding box, sum) for a 2-dimensional array
+ *
+ * See data_array1_enable_aggregates.
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @param enable True to enable, false to disable
+ */
+void data_array2_enable_aggregates(DataArray2 *arr, bool enable);
+
+/**
+ * @brief Enables or disables cached aggregates (bounding box, sum) for a 3-dimensional array
+ *
+ * See data_array1_enable_aggregates.
+ *
+ * @param arr Pointer to the 3-dimensional array
+ * @param enable True to enable, false to disable
+ */
+void data_array3_enable_aggregates(DataArray3 *arr, bool enable);
+
+/**
+ * @brief Invalidates all cached state of a 1-dimensional array after its data was modified directly
+ *
+ * @param arr Pointer to the 1-dimensional array
+ */
+void data_array1_invalidate_cache(DataArray1 *arr);
+
+/**
+ * @brief Invalidates all cached state of a 2-dimensional array after its data was modified directly
+ *
+ * @param arr Pointer to the 2-dimensional array
+ */
+void data_array2_invalidate_cache(DataArray2 *arr);
+
+/**
+ * @brief Invalidates all cached state of a 3-dimensional array after its data was modified directly
+ *
+ * @param arr Pointer to the 3-dimensional array
+ */
+void data_array3_invalidate_cache(DataArray3 *arr);
+
+
+/*
+* ------------------------------------
+* Uniform Spacing
+* ------------------------------------
+*/
+
+/**
+ * @brief Checks whether the x-values of a sorted 2-dimensional array are uniformly spaced and caches the result
+ *
+ * For uniformly spaced arrays, interpolate_from_sorted_data_array2, get_idx_of_func_x and
+ * data_array2_idx_from_binary_search compute the index arithmetically instead of searching (results stay
+ * identical). The cached result is dropped when the array is modified (append, insert, remove, clear or
+ * data_array2_invalidate_cache), after which searching is used again until this is called anew.
+ *
+ * @param arr Pointer to the 2-dimensional array (x is sorted)
+ * @param tolerance Allowed deviation of each x from the uniform grid relative to the spacing (e.g. 1e-9)
+ * @return True if the array has at least two entries, increasing x and uniform spacing within the tolerance
+ */
+bool data_array2_detect_uniform_spacing(DataArray2 *arr, double tolerance);
+
+/**
+ * @brief Returns the cached result of data_array2_detect_uniform_spacing
+ *
+ * @param arr Pointer to the 2-dimensional array
+ * @return True if the array was detected as uniformly spaced and has not been modified since
+ */
+bool data_array2_is_uniformly_spaced(DataArray2 *arr);
+
+
+/*
+* ------------------------------------
+* Aligned Storage
+* ------------------------------------
+*/
+
+/**
+ * @brief Sets the size from which heap buffers of DataArray1/2/3 are backed by transparent huge pages
+ *
+ * All heap buffers (and stack buffers) are 64-byte aligned. Buffers of at least num_bytes are mapped
+ * directly, aligned to 2 MiB and advised to use huge pages (MADV_HUGEPAGE), which reduces TLB misses
+ * when scanning very large arrays. The default threshold is 32 MiB.
+ *
+ * @param num_bytes Threshold in bytes (0 to always use the regular aligned heap)
+ */
+void data_array_set_huge_page_threshold(size_t num_bytes);
+
+/**
+ * @brief Returns the size from which heap buffers are backed by transparent huge pages (see data_array_set_huge_page_threshold)
+ *
+ * @return Threshold in bytes (0 if huge pages are not used)
+ */
+size_t data_array_get_huge_page_threshold();
+
+
+/*
+* ------------------------------------
+* Object Pool
+* ------------------------------------
+*/
+
+/**
+ * @brief Hit and miss counters of the object pool of the calling thread
+ */
+typedef struct DataArrayPoolStats {
+	size_t header_hits;		/**< DataArray1/2/3 created from a recycled header */
+	size_t header_misses;	/**< DataArray1/2/3 created with malloc while the pool was enabled */
+	size_t buffer_hits;		/**< Heap buffers taken from the pool */
+	size_t buffer_misses;	/**< Heap buffers allocated with malloc while the pool was enabled */
+	size_t cached_headers;	/**< Headers currently held by the pool */
+	size_t cached_bytes;	/**< Bytes of heap buffers currently held by the pool */
+} DataArrayPoolStats;
+
+/**
+ * @brief Enables or disables recycling of DataArray1/2/3 headers and heap buffers (disabled by default)
+ *
+ * Each thread keeps its own pool, so short-lived arrays (e.g. from data_array1_get_diff, data_array2_slice
+ * or get_line_intersections) skip malloc and free. Buffers are pooled by power-of-two capacity classes up
+ * to 16 MiB; while enabled, new heap buffers are rounded up to their class size. A thread's pool is
+ * released when the thread exits.
+ *
+ * @param enabled True to enable the pool for all threads
+ */
+void data_array_pool_set_enabled(bool enabled);
+
+/**
+ * @brief Returns the object pool counters of the calling thread
+ *
+ * @return Counters since the thread started or data_array_pool_reset_stats was called
+ */
+DataArrayPoolStats data_array_pool_get_stats();
+
+/**
+ * @brief Resets the hit and miss counters of the calling thread
+ */
+void data_array_pool_reset_stats();
+
+/**
+ * @brief Frees all headers and buffers held by the pool of the calling thread
+ */
+void data_array_pool_trim();
+
+
+/*
+* ------------------------------------
+* Instrumentation
+* ------------------------------------
+*/
+
+/**
+ * @brief Process-wide allocation and growth counters of all data arrays
+ *
+ * The counters are only maintained if the library is built with GEOMETRYLIB_INSTRUMENT
+ * (CMake option of the same name); otherwise the hooks compile to nothing and all counters stay 0.
+ * Byte counts include array headers (with their stack buffers), heap buffers and DataArrayN rows,
+ * but not file mappings.
+ */
+typedef struct DataArrayInstrumentStats {
+	bool enabled;					/**< True if the library was built with GEOMETRYLIB_INSTRUMENT */
+	size_t live_arrays[4];			/**< Arrays currently alive, indexed by DataArray1/2/3/N */
+	size_t live_heap_buffers;		/**< DataArray1/2/3 currently using a heap buffer instead of their stack buffer */
+	size_t allocated_bytes;			/**< Bytes currently held by arrays */
+	size_t peak_allocated_bytes;	/**< Maximum of allocated_bytes */
+	size_t total_allocated_bytes;	/**< Bytes allocated in total */
+	size_t growth_events;			/**< Reallocations of array memory (e.g. by appending beyond the capacity) */
+	size_t growth_copied_bytes;		/**< Bytes copied by reallocations */
+	size_t stack_to_heap_moves;		/**< Reallocations that moved a DataArray1/2/3 from its stack buffer to the heap */
+} DataArrayInstrumentStats;
+
+/**
+ * @brief Returns the allocation and growth counters of all data arrays
+ *
+ * @return Current counters (all 0 and enabled false if instrumentation is compiled out)
+ */
+DataArrayInstrumentStats data_array_get_instrument_stats();
+
+/**
+ * @brief Resets the cumulative counters (totals, growth and moves); the peak is set to the current allocation
+ */
+void data_array_reset_instrument_stats();
+
+/**
+ * @brief Writes counters as a JSON object (like snprintf)
+ *
+ * @param stats Counters from data_array_get_instrument_stats
+ * @param buffer Buffer for the null-terminated JSON text (may be NULL if buffer_size is 0)
+ * @param buffer_size Size of the buffer in bytes
+ * @return Length of the full JSON text (the text was truncated if this is not less than buffer_size)
+ */
+int data_array_instrument_stats_to_json(DataArrayInstrumentStats stats, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Prints the current counters as JSON to stdout
+ */
+void print_data_array_instrument_stats();
+
 #endif //GEOMETRYLIB_GEOMETRYLIB_DATATOOL_H
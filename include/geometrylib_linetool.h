@@ -11,15 +11,68 @@
  * ------------------------------------
  */
 
+/**
+ * @brief Cursor for interpolating a sorted 2-dimensional array at slowly advancing x-values
+ *
+ * Remembers the segment of the last query; the next one is searched from there (hunt search), so
+ * monotone or nearly monotone query sequences take O(1) amortized per lookup.
+ */
+typedef struct InterpolationCursor2 {
+	DataArray2 *data_array;	/**< Array the cursor is bound to (x is sorted) */
+	size_t idx;				/**< Index of the left point of the last segment */
+} InterpolationCursor2;
+
 /**
  * @brief Returns the interpolated y-value to a given x-value for a sorted 2-dimensional array
  *
  * @param data_array Pointer to the 2-dimensional array of (x, y) pairs (x is sorted)
  * @param x x-value for which the y-value is to be interpolated
- * @return Interpolated y-value
+ * @return Interpolated y-value (NAN if x is outside of the array's x-range)
  */
 double interpolate_from_sorted_data_array2(DataArray2 *data_array, double x);
 
+/**
+ * @brief Returns a cursor bound to a sorted 2-dimensional array (starting at its first segment)
+ *
+ * @param data_array Pointer to the 2-dimensional array of (x, y) pairs (x is sorted)
+ * @return Cursor
+ */
+InterpolationCursor2 interpolation_cursor2(DataArray2 *data_array);
+
+/**
+ * @brief Returns the interpolated y-value to a given x-value, searching from the cursor's last segment
+ *
+ * Results are identical to interpolate_from_sorted_data_array2.
+ *
+ * @param cursor Pointer to the cursor (updated to the segment of x)
+ * @param x x-value for which the y-value is to be interpolated
+ * @return Interpolated y-value (NAN if x is outside of the array's x-range)
+ */
+double interpolate_with_cursor2(InterpolationCursor2 *cursor, double x);
+
+/**
+ * @brief Interpolates the y-values to many sorted x-values of a sorted 2-dimensional array in one pass
+ *
+ * The queries are resolved by a single merge walk over the array instead of a binary search each; the
+ * interpolation itself is vectorized and very large query sets are split over multiple threads.
+ * Results are identical to calling interpolate_from_sorted_data_array2 for every x.
+ *
+ * @param data_array Pointer to the 2-dimensional array of (x, y) pairs (x is sorted)
+ * @param x Sorted x-values for which the y-values are to be interpolated
+ * @param y Output for the interpolated y-values (num_x values; NAN for x outside of the array's x-range)
+ * @param num_x Number of x-values
+ */
+void interpolate_values_from_sorted_data_array2(DataArray2 *data_array, const double *x, double *y, size_t num_x);
+
+/**
+ * @brief Interpolates the y-values to a sorted 1-dimensional array of x-values (see interpolate_values_from_sorted_data_array2)
+ *
+ * @param data_array Pointer to the 2-dimensional array of (x, y) pairs (x is sorted)
+ * @param x Pointer to the 1-dimensional array of sorted x-values
+ * @return Array of interpolated y-values (NAN for x outside of the array's x-range)
+ */
+DataArray1 * interpolate_batch_from_sorted_data_array2(DataArray2 *data_array, DataArray1 *x);
+
 
 /*
  * ------------------------------------
@@ -27,14 +80,118 @@ double interpolate_from_sorted_data_array2(DataArray2 *data_array, double x);
  * ------------------------------------
  */
 
+/**
+ * @brief Returns the intersection of two intersecting line segments (also for vertical segments)
+ *
+ * The point is interpolated along the first segment by the orientations of its endpoints relative to the
+ * second segment, so it always lies on the first segment.
+ *
+ * @param u0 Start point of the first segment
+ * @param u1 End point of the first segment
+ * @param v0 Start point of the second segment
+ * @param v1 End point of the second segment
+ * @return Intersection point (an endpoint of the overlap for collinear segments, NAN components for parallel ones)
+ */
+Vector2 get_line_segment_intersection(Vector2 u0, Vector2 u1, Vector2 v0, Vector2 v1);
+
 /**
  * @brief Returns all intersections between two line arrays
  *
+ * Both lines are swept together over x, so only segments with overlapping x-intervals are tested (O(n+m)).
+ * Long lines are split into x-ranges of line0's segments that are swept on multiple threads.
+ * The result equals the one of get_line_intersections_brute_force (regardless of thread count).
+ *
  * @param line0 Pointer to the first 2-dimensional array of (x, y) pairs (x is sorted)
  * @param line1 Pointer to the second 2-dimensional array of (x, y) pairs (x is sorted)
- * @return Array of intersections
+ * @return Array of intersections (ordered by the segment of line0, then by the segment of line1)
  */
 DataArray2 * get_line_intersections(DataArray2 *line0, DataArray2 *line1);
 
+/**
+ * @brief Returns all intersections between two line arrays by testing every pair of segments (O(n·m))
+ *
+ * Reference for validating get_line_intersections; it also finds the intersections of unsorted lines.
+ *
+ * @param line0 Pointer to the first 2-dimensional array of (x, y) pairs
+ * @param line1 Pointer to the second 2-dimensional array of (x, y) pairs
+ * @return Array of intersections (ordered by the segment of line0, then by the segment of line1)
+ */
+DataArray2 * get_line_intersections_brute_force(DataArray2 *line0, DataArray2 *line1);
+
+
+
+/*
+ * ------------------------------------
+ * Function Algebra
+ * ------------------------------------
+ */
+
+/**
+ * @brief Pointwise operation combining two piecewise-linear functions
+ */
+typedef enum PiecewiseLinearOperation {
+	PIECEWISE_ADD,				/**< f + g */
+	PIECEWISE_SUBTRACT,			/**< f - g */
+	PIECEWISE_MULTIPLY,			/**< f · g (exact at the output points only, quadratic in between) */
+	PIECEWISE_MIN,				/**< Lower envelope min(f, g) */
+	PIECEWISE_MAX,				/**< Upper envelope max(f, g) */
+	PIECEWISE_ABS_DIFFERENCE	/**< |f - g| */
+} PiecewiseLinearOperation;
+
+/**
+ * @brief Combines two piecewise-linear functions given by sorted 2-dimensional arrays in one merge pass (O(n+m))
+ *
+ * The result is sampled on the union of both x-grids within the common x-range, plus the points where f and g
+ * cross between grid points, so envelopes and differences are exact. Points with equal x (jumps) are kept.
+ *
+ * @param f Pointer to the first 2-dimensional array of (x, y) pairs (x is sorted)
+ * @param g Pointer to the second 2-dimensional array of (x, y) pairs (x is sorted)
+ * @param operation Pointwise operation
+ * @return Array of (x, f(x) op g(x)) pairs (empty if an array has fewer than 2 points or the x-ranges do not overlap)
+ */
+DataArray2 * combine_sorted_data_arrays2(DataArray2 *f, DataArray2 *g, PiecewiseLinearOperation operation);
+
+
+/*
+ * ------------------------------------
+ * Resampling
+ * ------------------------------------
+ */
+
+/**
+ * @brief How values between the points of the source array are obtained when resampling
+ */
+typedef enum ResampleMode {
+	RESAMPLE_LINEAR,		/**< Linear interpolation (same values as interpolate_from_sorted_data_array2) */
+	RESAMPLE_NEAREST,		/**< y of the point with the closest x (the left one for ties) */
+	RESAMPLE_NATURAL_CUBIC,	/**< Natural cubic spline (source x has to be strictly increasing) */
+	RESAMPLE_AKIMA,			/**< Akima spline (source x has to be strictly increasing) */
+	RESAMPLE_PCHIP			/**< Monotone cubic Hermite (source x has to be strictly increasing) */
+} ResampleMode;
+
+/**
+ * @brief Resamples a sorted 2-dimensional array onto a sorted x-grid
+ *
+ * All target points are resolved in one merge walk over the source (split into chunks on multiple threads
+ * for large grids); spline modes build the spline table once.
+ *
+ * @param data_array Pointer to the source 2-dimensional array of (x, y) pairs (x is sorted)
+ * @param x Pointer to the 1-dimensional array of target x-values (sorted)
+ * @param mode Resampling mode
+ * @return Array of (x, y) pairs on the target grid (y is NAN outside of the source's x-range)
+ */
+DataArray2 * resample_sorted_data_array2(DataArray2 *data_array, DataArray1 *x, ResampleMode mode);
+
+/**
+ * @brief Resamples a sorted 2-dimensional array onto the uniform grid x0 + k·dx (see resample_sorted_data_array2)
+ *
+ * @param data_array Pointer to the source 2-dimensional array of (x, y) pairs (x is sorted)
+ * @param x0 First x-value of the grid
+ * @param dx Spacing of the grid (positive)
+ * @param num_x Number of grid points
+ * @param mode Resampling mode
+ * @return Array of (x, y) pairs on the target grid (y is NAN outside of the source's x-range)
+ */
+DataArray2 * resample_sorted_data_array2_uniform(DataArray2 *data_array, double x0, double dx, size_t num_x, ResampleMode mode);
 
 #endif //KMAT_GEOMETRYLIB_LINETOOL_H
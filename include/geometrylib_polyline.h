@@ -0,0 +1,302 @@
+#ifndef KMAT_GEOMETRYLIB_POLYLINE_H
+#define KMAT_GEOMETRYLIB_POLYLINE_H
+
+#include "geometrylib_datatool.h"
+
+
+/*
+ * ------------------------------------
+ * Structures
+ * ------------------------------------
+ */
+
+/**
+ * @brief Polyline simplification algorithm
+ */
+typedef enum PolylineSimplification {
+	POLYLINE_SIMPLIFY_RDP,			/**< Ramer-Douglas-Peucker: removed points lie within tolerance of the kept segment */
+	POLYLINE_SIMPLIFY_VISVALINGAM,	/**< Visvalingam-Whyatt: removes points with effective triangle area below tolerance² */
+	POLYLINE_SIMPLIFY_STREAMING		/**< Single pass with constant work per point: removed points lie within tolerance of the kept segment */
+} PolylineSimplification;
+
+/**
+ * @brief Single-pass simplifier for polylines that arrive point by point (e.g. chunks of a DataArrayStream)
+ */
+typedef struct PolylineSimplifier PolylineSimplifier;
+
+/**
+ * @brief Static bounding volume hierarchy over the consecutive segments of a 2-dimensional polyline
+ *
+ * Built from a snapshot of the polyline (later changes of the array are not seen). Leaves hold short runs of
+ * consecutive segments; nodes are stored in depth-first order with the left child next to its parent.
+ */
+typedef struct PolylineBVH2 PolylineBVH2;
+
+/**
+ * @brief Static bounding volume hierarchy over the consecutive segments of a 3-dimensional polyline (see PolylineBVH2)
+ */
+typedef struct PolylineBVH3 PolylineBVH3;
+
+
+/*
+ * ------------------------------------
+ * Intersections
+ * ------------------------------------
+ */
+
+/**
+ * @brief Returns all intersections between two general polylines (x does not need to be sorted)
+ *
+ * The polylines are split into short x-monotone chains, whose bounding boxes are kept in a hierarchy; only chains
+ * with overlapping bounding boxes are found and intersected, each by a sweep over both chains. This is close to
+ * O(n log n + k) for curve-like polylines, also for many loops stacked over the same x-range (e.g. ground tracks).
+ * Intersection points are computed from orientation predicates, so vertical segments are handled.
+ * A crossing exactly at a vertex is reported once.
+ * The chains of very large polylines are swept on multiple threads; the result does not depend on the thread count.
+ *
+ * @param line0 Pointer to the first 2-dimensional array of (x, y) pairs
+ * @param line1 Pointer to the second 2-dimensional array of (x, y) pairs
+ * @return Array of intersections (ordered by the segment of line0, then by the segment of line1)
+ */
+DataArray2 * get_polyline_intersections(DataArray2 *line0, DataArray2 *line1);
+
+/**
+ * @brief Returns all self-intersections of a general polyline (e.g. a closed or self-crossing track)
+ *
+ * Adjacent segments (and the first and last segment of a closed polyline) are not tested against each other.
+ *
+ * @param line Pointer to the 2-dimensional array of (x, y) pairs
+ * @return Array of intersections (ordered by the first, then by the second of the two crossing segments)
+ */
+DataArray2 * get_polyline_self_intersections(DataArray2 *line);
+
+
+
+/*
+ * ------------------------------------
+ * Simplification
+ * ------------------------------------
+ */
+
+/**
+ * @brief Simplifies a polyline and returns the indices of the kept points
+ *
+ * The first and the last point are always kept.
+ *
+ * @param line Pointer to the 2-dimensional array of (x, y) pairs
+ * @param tolerance Maximum distance of removed points (for POLYLINE_SIMPLIFY_VISVALINGAM: square root of the area threshold)
+ * @param method Simplification algorithm
+ * @param indices Output for the ascending indices of the kept points (room for data_array2_size(line) values)
+ * @return Number of kept points
+ */
+size_t simplify_polyline2_indices(DataArray2 *line, double tolerance, PolylineSimplification method, size_t *indices);
+
+/**
+ * @brief Simplifies a polyline in 3D and returns the indices of the kept points (see simplify_polyline2_indices)
+ *
+ * @param line Pointer to the 3-dimensional array of (x, y, z) points
+ * @param tolerance Maximum distance of removed points (for POLYLINE_SIMPLIFY_VISVALINGAM: square root of the area threshold)
+ * @param method Simplification algorithm
+ * @param indices Output for the ascending indices of the kept points (room for data_array3_size(line) values)
+ * @return Number of kept points
+ */
+size_t simplify_polyline3_indices(DataArray3 *line, double tolerance, PolylineSimplification method, size_t *indices);
+
+/**
+ * @brief Returns a simplified copy of a polyline (see simplify_polyline2_indices)
+ *
+ * @param line Pointer to the 2-dimensional array of (x, y) pairs
+ * @param tolerance Maximum distance of removed points (for POLYLINE_SIMPLIFY_VISVALINGAM: square root of the area threshold)
+ * @param method Simplification algorithm
+ * @return Array of the kept points
+ */
+DataArray2 * simplify_polyline2(DataArray2 *line, double tolerance, PolylineSimplification method);
+
+/**
+ * @brief Returns a simplified copy of a polyline in 3D (see simplify_polyline2_indices)
+ *
+ * @param line Pointer to the 3-dimensional array of (x, y, z) points
+ * @param tolerance Maximum distance of removed points (for POLYLINE_SIMPLIFY_VISVALINGAM: square root of the area threshold)
+ * @param method Simplification algorithm
+ * @return Array of the kept points
+ */
+DataArray3 * simplify_polyline3(DataArray3 *line, double tolerance, PolylineSimplification method);
+
+/**
+ * @brief Creates a single-pass simplifier (same result as POLYLINE_SIMPLIFY_STREAMING over the whole polyline)
+ *
+ * Each point is decided in constant time and memory without lookahead, so depending on the curve more or fewer
+ * points are kept than with POLYLINE_SIMPLIFY_RDP; in 3D the admissible directions are narrowed conservatively.
+ *
+ * @param tolerance Maximum distance of removed points to the kept segment
+ * @return Pointer to the newly allocated simplifier
+ */
+PolylineSimplifier * polyline_simplifier_create(double tolerance);
+
+/**
+ * @brief Adds the next point of a 2-dimensional polyline; points that are known to be kept are appended to out
+ *
+ * @param simplifier Pointer to the simplifier
+ * @param point Next point
+ * @param out Pointer to the 2-dimensional array that receives the kept points
+ */
+void polyline_simplifier_add2(PolylineSimplifier *simplifier, Vector2 point, DataArray2 *out);
+
+/**
+ * @brief Adds the next point of a 3-dimensional polyline; points that are known to be kept are appended to out
+ *
+ * @param simplifier Pointer to the simplifier
+ * @param point Next point
+ * @param out Pointer to the 3-dimensional array that receives the kept points
+ */
+void polyline_simplifier_add3(PolylineSimplifier *simplifier, Vector3 point, DataArray3 *out);
+
+/**
+ * @brief Appends the last point of a 2-dimensional polyline and resets the simplifier for a new polyline
+ *
+ * @param simplifier Pointer to the simplifier
+ * @param out Pointer to the 2-dimensional array that receives the kept points
+ */
+void polyline_simplifier_finish2(PolylineSimplifier *simplifier, DataArray2 *out);
+
+/**
+ * @brief Appends the last point of a 3-dimensional polyline and resets the simplifier for a new polyline
+ *
+ * @param simplifier Pointer to the simplifier
+ * @param out Pointer to the 3-dimensional array that receives the kept points
+ */
+void polyline_simplifier_finish3(PolylineSimplifier *simplifier, DataArray3 *out);
+
+/**
+ * @brief Frees a simplifier
+ *
+ * @param simplifier Pointer to the simplifier
+ */
+void polyline_simplifier_free(PolylineSimplifier *simplifier);
+
+
+
+/*
+ * ------------------------------------
+ * Segment Hierarchy
+ * ------------------------------------
+ */
+
+/**
+ * @brief Builds a bounding volume hierarchy over the segments of a 2-dimensional polyline (O(n))
+ *
+ * @param line Pointer to the 2-dimensional array of (x, y) pairs
+ * @return Pointer to the newly allocated hierarchy (without segments if line has fewer than 2 points)
+ */
+PolylineBVH2 * polyline_bvh2_create(DataArray2 *line);
+
+/**
+ * @brief Builds a bounding volume hierarchy over the segments of a 3-dimensional polyline (O(n))
+ *
+ * @param line Pointer to the 3-dimensional array of (x, y, z) points
+ * @return Pointer to the newly allocated hierarchy (without segments if line has fewer than 2 points)
+ */
+PolylineBVH3 * polyline_bvh3_create(DataArray3 *line);
+
+/**
+ * @brief Frees a 2-dimensional segment hierarchy
+ *
+ * @param bvh Pointer to the hierarchy
+ */
+void polyline_bvh2_free(PolylineBVH2 *bvh);
+
+/**
+ * @brief Frees a 3-dimensional segment hierarchy
+ *
+ * @param bvh Pointer to the hierarchy
+ */
+void polyline_bvh3_free(PolylineBVH3 *bvh);
+
+/**
+ * @brief Returns the intersections of a segment with the indexed polyline
+ *
+ * Like get_line_intersections, a crossing at a vertex is reported by both segments sharing it.
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param p0 Start point of the segment
+ * @param p1 End point of the segment
+ * @return Array of intersections (ordered by the segment of the indexed polyline)
+ */
+DataArray2 * polyline_bvh2_get_segment_intersections(PolylineBVH2 *bvh, Vector2 p0, Vector2 p1);
+
+/**
+ * @brief Returns the intersections of every segment of a polyline with the indexed polyline (batch query)
+ *
+ * The segments of long query polylines are processed on multiple threads; the result does not depend on the thread count.
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param line Pointer to the 2-dimensional array of (x, y) pairs of the query polyline
+ * @return Array of intersections (ordered by the segment of line, then by the segment of the indexed polyline)
+ */
+DataArray2 * polyline_bvh2_get_line_intersections(PolylineBVH2 *bvh, DataArray2 *line);
+
+/**
+ * @brief Finds the segment of the indexed polyline closest to a point
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param point Query point
+ * @param closest Output for the closest point on that segment (can be NULL)
+ * @return Index of the closest segment (the lowest one for ties; SIZE_MAX if the hierarchy has no segments)
+ */
+size_t polyline_bvh2_nearest_segment(PolylineBVH2 *bvh, Vector2 point, Vector2 *closest);
+
+/**
+ * @brief Finds the segment of the indexed polyline closest to a point in 3D
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param point Query point
+ * @param closest Output for the closest point on that segment (can be NULL)
+ * @return Index of the closest segment (the lowest one for ties; SIZE_MAX if the hierarchy has no segments)
+ */
+size_t polyline_bvh3_nearest_segment(PolylineBVH3 *bvh, Vector3 point, Vector3 *closest);
+
+/**
+ * @brief Finds the closest segment for each of several points (batch query, on multiple threads for many points)
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param points Query points
+ * @param num_points Number of query points
+ * @param segments Output for the index of the closest segment of each point (num_points values)
+ * @param closest Output for the closest point on that segment (num_points values, can be NULL)
+ */
+void polyline_bvh2_nearest_segments(PolylineBVH2 *bvh, const Vector2 *points, size_t num_points, size_t *segments, Vector2 *closest);
+
+/**
+ * @brief Finds the closest segment for each of several points in 3D (see polyline_bvh2_nearest_segments)
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param points Query points
+ * @param num_points Number of query points
+ * @param segments Output for the index of the closest segment of each point (num_points values)
+ * @param closest Output for the closest point on that segment (num_points values, can be NULL)
+ */
+void polyline_bvh3_nearest_segments(PolylineBVH3 *bvh, const Vector3 *points, size_t num_points, size_t *segments, Vector3 *closest);
+
+/**
+ * @brief Finds all segments of the indexed polyline that intersect an axis-aligned box (range query)
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param min Minimum corner of the box
+ * @param max Maximum corner of the box
+ * @param segments Output for the ascending indices of the segments (room for the number of segments of the polyline)
+ * @return Number of segments found
+ */
+size_t polyline_bvh2_segments_in_box(PolylineBVH2 *bvh, Vector2 min, Vector2 max, size_t *segments);
+
+/**
+ * @brief Finds all segments of the indexed polyline that intersect an axis-aligned box in 3D (range query)
+ *
+ * @param bvh Pointer to the hierarchy
+ * @param min Minimum corner of the box
+ * @param max Maximum corner of the box
+ * @param segments Output for the ascending indices of the segments (room for the number of segments of the polyline)
+ * @return Number of segments found
+ */
+size_t polyline_bvh3_segments_in_box(PolylineBVH3 *bvh, Vector3 min, Vector3 max, size_t *segments);
+
+#endif //KMAT_GEOMETRYLIB_POLYLINE_H
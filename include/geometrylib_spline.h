@@ -0,0 +1,125 @@
+#ifndef KMAT_GEOMETRYLIB_SPLINE_H
+#define KMAT_GEOMETRYLIB_SPLINE_H
+
+#include "geometrylib_datatool.h"
+
+
+/*
+ * ------------------------------------
+ * Structures
+ * ------------------------------------
+ */
+
+/**
+ * @brief Kind of piecewise cubic interpolation
+ */
+typedef enum SplineType {
+	SPLINE_NATURAL_CUBIC,	/**< C2 cubic spline with zero second derivative at both ends */
+	SPLINE_AKIMA,			/**< C1 Akima spline (local, little overshoot near outliers) */
+	SPLINE_PCHIP			/**< C1 monotone piecewise cubic Hermite (Fritsch-Carlson, no overshoot) */
+} SplineType;
+
+/**
+ * @brief Read-only spline over a sorted 2-dimensional array
+ *
+ * The knot x and the four polynomial coefficients of every interval are precomputed and stored
+ * contiguously, so an evaluation is one search plus one Horner polynomial (uniformly spaced knots
+ * are located arithmetically).
+ */
+typedef struct SplineTable SplineTable;
+
+/**
+ * @brief Cursor for evaluating a spline at slowly advancing x-values (hunt search from the last interval)
+ */
+typedef struct SplineCursor {
+	SplineTable *table;	/**< Spline the cursor is bound to */
+	size_t idx;			/**< Index of the last interval */
+} SplineCursor;
+
+
+/*
+ * ------------------------------------
+ * Create and Free
+ * ------------------------------------
+ */
+
+/**
+ * @brief Builds a spline through the points of a sorted 2-dimensional array (the array stays unchanged)
+ *
+ * With two points every spline type is the straight line through them.
+ *
+ * @param arr Pointer to the 2-dimensional array of (x, y) pairs (x is strictly increasing)
+ * @param type Kind of spline
+ * @return Pointer to the newly allocated spline (NULL if arr has less than two points or x is not strictly increasing)
+ */
+SplineTable * spline_table_create(DataArray2 *arr, SplineType type);
+
+/**
+ * @brief Frees a spline
+ *
+ * @param table Pointer to the spline
+ */
+void spline_table_free(SplineTable *table);
+
+/**
+ * @brief Returns the number of knots of a spline
+ *
+ * @param table Pointer to the spline
+ * @return Number of knots (points of the array it was built from)
+ */
+size_t spline_table_size(SplineTable *table);
+
+
+/*
+ * ------------------------------------
+ * Evaluation
+ * ------------------------------------
+ */
+
+/**
+ * @brief Evaluates a spline
+ *
+ * @param table Pointer to the spline
+ * @param x x-value
+ * @return Interpolated y-value (NAN if x is outside of the knots' x-range)
+ */
+double spline_table_evaluate(SplineTable *table, double x);
+
+/**
+ * @brief Returns a cursor bound to a spline (starting at its first interval)
+ *
+ * @param table Pointer to the spline
+ * @return Cursor
+ */
+SplineCursor spline_cursor(SplineTable *table);
+
+/**
+ * @brief Evaluates a spline, searching from the cursor's last interval (O(1) amortized for monotone queries)
+ *
+ * @param cursor Pointer to the cursor (updated to the interval of x)
+ * @param x x-value
+ * @return Interpolated y-value (NAN if x is outside of the knots' x-range)
+ */
+double spline_evaluate_with_cursor(SplineCursor *cursor, double x);
+
+/**
+ * @brief Evaluates a spline at many sorted x-values in one merge walk (very large sets on multiple threads)
+ *
+ * @param table Pointer to the spline
+ * @param x Sorted x-values
+ * @param y Output for the interpolated y-values (num_x values; NAN for x outside of the knots' x-range)
+ * @param num_x Number of x-values
+ */
+void spline_table_evaluate_values(SplineTable *table, const double *x, double *y, size_t num_x);
+
+/**
+ * @brief Evaluates a spline at a sorted 1-dimensional array of x-values (see spline_table_evaluate_values)
+ *
+ * @param table Pointer to the spline
+ * @param x Pointer to the 1-dimensional array of sorted x-values
+ * @return Array of interpolated y-values (NAN for x outside of the knots' x-range)
+ */
+DataArray1 * spline_table_evaluate_batch(SplineTable *table, DataArray1 *x);
+
+
+#endif //KMAT_GEOMETRYLIB_SPLINE_H
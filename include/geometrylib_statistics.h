@@ -0,0 +1,154 @@
+#ifndef KMAT_GEOMETRYLIB_STATISTICS_H
+#define KMAT_GEOMETRYLIB_STATISTICS_H
+
+#include "geometrylib_datatool.h"
+
+
+/*
+ * ------------------------------------
+ * Structures
+ * ------------------------------------
+ */
+
+/**
+ * @brief Boxplot statistics (five-number summary and mean)
+ */
+typedef struct DataStats1 {
+	double min;		/**< Minimum */
+	double q1;		/**< First quartile */
+	double median;	/**< Median */
+	double q3;		/**< Third quartile */
+	double max;		/**< Maximum */
+	double mean;	/**< Arithmetic mean */
+	size_t count;	/**< Number of (non-NaN) values the statistics are based on */
+} DataStats1;
+
+/**
+ * @brief Mergeable streaming quantile sketch (KLL) for data that does not fit into memory
+ */
+typedef struct QuantileSketch QuantileSketch;
+
+
+/*
+ * ------------------------------------
+ * In-memory Statistics
+ * ------------------------------------
+ */
+
+/**
+ * @brief Returns the q-quantile of an unsorted 1-dimensional array in O(n)
+ *
+ * Uses quickselect on a copy of the data and interpolates linearly between the closest ranks.
+ * NaN values are ignored.
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @param q Quantile (0 ≤ q ≤ 1)
+ * @return q-quantile (NAN if the array is NULL, empty or q is out of range)
+ */
+double data_array1_get_quantile(DataArray1 *arr, double q);
+
+/**
+ * @brief Returns min, first quartile, median, third quartile, max and mean of an unsorted 1-dimensional array in O(n)
+ *
+ * Uses quickselect on a copy of the data and interpolates linearly between the closest ranks.
+ * NaN values are ignored.
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @return Statistics (all NAN and count 0 if the array is NULL or contains no values)
+ */
+DataStats1 data_array1_get_stats(DataArray1 *arr);
+
+/**
+ * @brief Same as data_array1_get_stats but reorders the array in place instead of copying it
+ *
+ * The order of the elements is undefined afterwards. NaN values are moved to the end of the array.
+ *
+ * @param arr Pointer to the 1-dimensional array
+ * @return Statistics (all NAN and count 0 if the array is NULL or contains no values)
+ */
+DataStats1 data_array1_get_stats_inplace(DataArray1 *arr);
+
+/**
+ * @brief Prints statistics in the same format as print_data_array1_boxplot
+ *
+ * @param stats Statistics to print
+ */
+void print_data_stats1(DataStats1 stats);
+
+
+/*
+ * ------------------------------------
+ * Streaming Quantile Sketch
+ * ------------------------------------
+ */
+
+/**
+ * @brief Creates a new quantile sketch
+ *
+ * Memory is O(k · log(n/k)). The rank error is roughly 1.7/k (k = 200 → about 1%).
+ * Min, max, mean and count are exact.
+ *
+ * @param k Accuracy parameter (values below 8 are raised to 8)
+ * @return Pointer to the newly allocated sketch
+ */
+QuantileSketch * quantile_sketch_create(int k);
+
+/**
+ * @brief Frees a quantile sketch
+ *
+ * @param sketch Pointer to the sketch
+ */
+void quantile_sketch_free(QuantileSketch *sketch);
+
+/**
+ * @brief Adds a value to the sketch (NaN values are ignored)
+ *
+ * @param sketch Pointer to the sketch
+ * @param value Value to add
+ */
+void quantile_sketch_add(QuantileSketch *sketch, double value);
+
+/**
+ * @brief Adds all values of a 1-dimensional array to the sketch
+ *
+ * @param sketch Pointer to the sketch
+ * @param arr Pointer to the 1-dimensional array
+ */
+void quantile_sketch_add_data_array1(QuantileSketch *sketch, DataArray1 *arr);
+
+/**
+ * @brief Merges the sketch src into dst (src stays unchanged)
+ *
+ * Sketches built on separate parts of the data (e.g. per thread or per file) can be merged into one.
+ *
+ * @param dst Pointer to the sketch that receives the values
+ * @param src Pointer to the sketch to merge
+ */
+void quantile_sketch_merge(QuantileSketch *dst, QuantileSketch *src);
+
+/**
+ * @brief Returns the number of values added to the sketch
+ *
+ * @param sketch Pointer to the sketch
+ * @return Number of values
+ */
+size_t quantile_sketch_count(QuantileSketch *sketch);
+
+/**
+ * @brief Returns the approximate q-quantile of all values added to the sketch
+ *
+ * @param sketch Pointer to the sketch
+ * @param q Quantile (0 ≤ q ≤ 1)
+ * @return Approximate q-quantile (NAN if the sketch is empty or q is out of range)
+ */
+double quantile_sketch_get_quantile(QuantileSketch *sketch, double q);
+
+/**
+ * @brief Returns statistics of all values added to the sketch (quartiles and median are approximated)
+ *
+ * @param sketch Pointer to the sketch
+ * @return Statistics (all NAN and count 0 if the sketch is empty)
+ */
+DataStats1 quantile_sketch_get_stats(QuantileSketch *sketch);
+
+#endif //KMAT_GEOMETRYLIB_STATISTICS_H
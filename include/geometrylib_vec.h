@@ -153,6 +153,28 @@ double determinant2(Vector2 v1, Vector2 v2);
 Vector2 proj_vec2_vec2(Vector2 v1, Vector2 v2);
 
 
+/**
+ * @brief Calculates the orientation of three points (twice the signed area of the triangle a, b, c)
+ *
+ * @param a First point
+ * @param b Second point
+ * @param c Third point
+ * @return Positive if c lies left of the line from a to b, negative if right of it, 0 if collinear
+ */
+double orientation2(Vector2 a, Vector2 b, Vector2 c);
+
+
+/**
+ * @brief Determines whether a point lies within the bounding box of a line segment (used for collinear points)
+ *
+ * @param a First position of the line segment
+ * @param b Second position of the line segment
+ * @param p Point
+ * @return 1 if p lies within the bounding box of the segment, 0 otherwise
+ */
+int on_segment2(Vector2 a, Vector2 b, Vector2 p);
+
+
 /**
  * @brief Determines whether two line segments are intersecting (or touching)
  *
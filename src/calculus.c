@@ -4,6 +4,7 @@
 #include "geometrylib_calculus.h"
 #include "data_array_def.h"
 #include "geometrylib_linetool.h"
+#include "simd.h"
 
 double get_y_value_from_x_value_of_line(Vector2 p0, Vector2 p1, double x) {
 	double m = (p1.y - p0.y)/(p1.x - p0.x);
@@ -43,6 +44,73 @@ double get_single_shifted_root_of_line_array(DataArray2 *arr, double y) {
 	return get_x_value_from_y_value_of_line(arr->data[idx0], arr->data[idx1], y);
 }
 
+static int compare_doubles(const void *a, const void *b) {
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+static int compare_crossings(const void *a, const void *b) {
+	const Vector2 *c0 = a, *c1 = b;
+	if(c0->x != c1->x) return (c0->x > c1->x) - (c0->x < c1->x);
+	return (c0->y > c1->y) - (c0->y < c1->y);
+}
+
+// number of sorted levels that are not above y, walked from the band of the previous point
+static size_t get_level_band(const double *levels, size_t num_levels, size_t band, double y) {
+	while(band < num_levels && !(y < levels[band])) band++;
+	while(band > 0 && y < levels[band-1]) band--;
+	return band;
+}
+
+DataArray2 * get_level_crossings_of_line_array(DataArray2 *arr, const double *levels, size_t num_levels) {
+	DataArray2 *crossings = data_array2_create();
+	if(!arr || arr->count < 2 || !levels || num_levels == 0) return crossings;
+
+	double *sorted = malloc(num_levels * sizeof(double));
+	size_t num_sorted = 0;
+	for(size_t l = 0; l < num_levels; l++) if(!isnan(levels[l])) sorted[num_sorted++] = levels[l];
+	qsort(sorted, num_sorted, sizeof(double), compare_doubles);
+
+	const double *points = (const double *) arr->data;
+	size_t n = arr->count, i = 0;
+	while(i < n && isnan(arr->data[i].y)) i++;
+	size_t band = i < n ? get_level_band(sorted, num_sorted, 0, arr->data[i].y) : 0;
+	bool sorted_x = true;
+
+	while(i+1 < n) {
+		double lo = band > 0 ? sorted[band-1] : -INFINITY, hi = band < num_sorted ? sorted[band] : INFINITY;
+		size_t j = i+1 + simd_find_y_outside2(points + 2*(i+1), n-(i+1), lo, hi);
+		if(j == n) break;
+
+		if(isnan(arr->data[j].y)) {
+			// restarts behind the gap without crossings
+			while(j < n && isnan(arr->data[j].y)) j++;
+			if(j < n) band = get_level_band(sorted, num_sorted, band, arr->data[j].y);
+			i = j;
+			continue;
+		}
+
+		Vector2 p0 = arr->data[j-1], p1 = arr->data[j];
+		size_t new_band = get_level_band(sorted, num_sorted, band, p1.y);
+		if(new_band > band) {
+			for(size_t l = band; l < new_band; l++) data_array2_append_new(crossings, vec2(get_x_value_from_y_value_of_line(p0, p1, sorted[l]), sorted[l]));
+		} else {
+			for(size_t l = band; l > new_band; l--) data_array2_append_new(crossings, vec2(get_x_value_from_y_value_of_line(p0, p1, sorted[l-1]), sorted[l-1]));
+		}
+		if(p1.x < p0.x) sorted_x = false;
+		band = new_band;
+		i = j;
+	}
+
+	// crossings come in order of the segments, which only needs sorting if x is not sorted
+	if(!sorted_x) {
+		qsort(crossings->data, crossings->count, sizeof(Vector2), compare_crossings);
+		data_array2_invalidate_cache(crossings);
+	}
+	free(sorted);
+	return crossings;
+}
+
 DataArray1 * data_array1_get_diff(DataArray1 *arr) {
 	if(!arr) return NULL;
 	DataArray1 *diff = data_array1_create();
@@ -103,6 +171,73 @@ double root_finder_monot_func_next_x(DataArray2 *arr, double min_diff_ratio, dou
 	return get_next_x_for_root_search_from_line(arr->data[idx0], arr->data[idx1], min_diff_ratio, min_dx);
 }
 
+// empties the array but keeps its memory for the next search
+static void reset_root_finder_work(DataArray2 *work, size_t max_evaluations) {
+	if(work->mapping) {
+		data_array2_clear(work);
+	} else {
+		work->count = 0;
+		data_array2_invalidate_cache(work);
+	}
+	data_array2_reserve(work, max_evaluations);
+}
+
+RootFinderResult find_root_of_monot_func(RootFunction func, void *ctx, double x0, double x1, double min_diff_ratio,
+										 double x_tol, double y_tol, size_t max_evaluations, DataArray2 *work) {
+	RootFinderResult result = {NAN, 0, false};
+	if(!func || !(x0 < x1)) return result;
+	if(max_evaluations < 2) max_evaluations = 2;
+	DataArray2 *points = work ? work : data_array2_create();
+	reset_root_finder_work(points, max_evaluations);
+
+	// lo and hi bracket the sign change; lo keeps the sign of f(x0)
+	Vector2 lo = vec2(x0, func(x0, ctx)), hi = vec2(x1, func(x1, ctx));
+	result.num_evaluations = 2;
+	data_array2_insert_new(points, lo);
+	data_array2_insert_new(points, hi);
+
+	if(fabs(lo.y) <= y_tol || fabs(hi.y) <= y_tol) {
+		result.root = fabs(lo.y) <= fabs(hi.y) ? lo.x : hi.x;
+		result.converged = true;
+	} else if((lo.y < 0) != (hi.y < 0) && !isnan(lo.y) && !isnan(hi.y)) {
+		while(true) {
+			if(hi.x - lo.x <= x_tol) {
+				result.root = get_x_value_from_y_value_of_line(lo, hi, 0);
+				result.converged = true;
+				break;
+			}
+			if(result.num_evaluations == max_evaluations) {
+				result.root = get_x_value_from_y_value_of_line(lo, hi, 0);
+				break;
+			}
+
+			double x = root_finder_monot_func_next_x(points, min_diff_ratio, x_tol/4);
+			// the step oracle declines once the bracket gets too small; bisect instead of stalling
+			if(!(x > lo.x && x < hi.x)) x = (lo.x + hi.x) / 2;
+			if(!(x > lo.x && x < hi.x)) {
+				result.root = get_x_value_from_y_value_of_line(lo, hi, 0);
+				result.converged = true;
+				break;
+			}
+
+			Vector2 p = vec2(x, func(x, ctx));
+			result.num_evaluations++;
+			data_array2_insert_new(points, p);
+			if(isnan(p.y)) break;
+			if(fabs(p.y) <= y_tol) {
+				result.root = x;
+				result.converged = true;
+				break;
+			}
+			if((p.y < 0) == (lo.y < 0)) lo = p;
+			else hi = p;
+		}
+	}
+
+	if(!work) data_array2_free(points);
+	return result;
+}
+
 int get_idx_of_unimodal_func_minimum(DataArray2 *arr) {
 	if(arr->count == 0) return NAN;
 	if(arr->count == 1 || arr->data[0].y < arr->data[1].y) return 0;
@@ -156,21 +291,13 @@ int get_idx_of_func_x(DataArray2 *arr, double x) {
 
 	if(x < arr->data[0].x || x > arr->data[arr->count-1].x) return NAN;
 
-	int idx0 = 0, idx1 = (int) arr->count - 1, idx_x = -1;
-
-	while(idx0 < idx1-1) {
-		int idx_m = (idx0 + idx1)/2;
-		if(arr->data[idx_m].x <= x && arr->data[idx_m+1].x > x) {
-			idx_x = idx_m; break;
-		}
-
-		if(arr->data[idx_m].y > arr->data[idx_m-1].y) idx0 = idx_m;
-		else idx1 = idx_m;
-	}
-
-	if(idx_x < 0) idx_x = idx0;
+	// last entry with an x not bigger than the given one (the last segment for x at the end)
+	size_t idx_x = data_array2_lower_bound_x(arr, x);
+	while(idx_x < arr->count && arr->data[idx_x].x == x) idx_x++;
+	if(idx_x > 0) idx_x--;
+	if(idx_x > arr->count-2) idx_x = arr->count-2;
 
-	return idx_x;
+	return (int) idx_x;
 }
 
 Vector2 get_xn(Vector2 d0, Vector2 d1, double m_l, double m_r) {
@@ -2,33 +2,79 @@
 #define KMAT_DATA_ARRAY_DEF_H
 
 #include "geometrylib_vec.h"
+#include "geometrylib_datatool.h"
+#include "geometrylib_databin.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 
 #define DATA_ARRAY_STACK_LIMIT 128
 
+// minimum number of elements per thread for the multithreaded paths of very large arrays
+#define DATA_ARRAY_PARALLEL_MIN_CHUNK (1 << 20)
+
+// opt-in aggregates that are updated on append/insert and recomputed lazily once invalidated
+typedef struct DataAggregates1 {
+	bool enabled;
+	bool valid;
+	DataBounds1 bounds;
+	double sum;
+} DataAggregates1;
+
+typedef struct DataAggregates2 {
+	bool enabled;
+	bool valid;
+	DataBounds2 bounds;
+	Vector2 sum;
+} DataAggregates2;
+
+typedef struct DataAggregates3 {
+	bool enabled;
+	bool valid;
+	DataBounds3 bounds;
+	Vector3 sum;
+} DataAggregates3;
+
+// uniform x-spacing of a sorted DataArray2, detected on request and dropped on every modification
+typedef struct DataSpacing2 {
+	bool valid;
+	bool uniform;
+	double x0;
+	double inv_dx;
+} DataSpacing2;
+
 typedef struct DataArray1 {
-	double stack_buffer[DATA_ARRAY_STACK_LIMIT];
+	_Alignas(64) double stack_buffer[DATA_ARRAY_STACK_LIMIT];
 	double* data;
 	size_t count;
 	size_t capacity;
 	bool using_heap;
+	void *mapping;			// read-only file mapping the data points into (NULL if not mapped)
+	size_t mapping_size;
+	DataAggregates1 aggregates;
 } DataArray1;
 
 typedef struct DataArray2 {
-	Vector2 stack_buffer[DATA_ARRAY_STACK_LIMIT];
+	_Alignas(64) Vector2 stack_buffer[DATA_ARRAY_STACK_LIMIT];
 	Vector2* data;
 	size_t count;
 	size_t capacity;
 	bool using_heap;
+	void *mapping;			// read-only file mapping the data points into (NULL if not mapped)
+	size_t mapping_size;
+	DataAggregates2 aggregates;
+	DataSpacing2 spacing;
 } DataArray2;
 
 typedef struct DataArray3 {
-	Vector3 stack_buffer[DATA_ARRAY_STACK_LIMIT];
+	_Alignas(64) Vector3 stack_buffer[DATA_ARRAY_STACK_LIMIT];
 	Vector3* data;
 	size_t count;
 	size_t capacity;
 	bool using_heap;
+	void *mapping;			// read-only file mapping the data points into (NULL if not mapped)
+	size_t mapping_size;
+	DataAggregates3 aggregates;
 } DataArray3;
 
 typedef struct DataArrayN {
@@ -38,4 +84,29 @@ typedef struct DataArrayN {
 	size_t capacity;
 } DataArrayN;
 
+// first index whose x is not smaller than x (x is sorted); O(1) for arrays detected as uniformly spaced
+size_t data_array2_lower_bound_x(DataArray2 *arr, double x);
+
+// object pool (datapool.c): 64-byte aligned headers and heap buffers of DataArray1/2/3 (not recycled while disabled)
+void * data_array_pool_alloc_header(DataArrayType type, size_t size);
+void data_array_pool_free_header(DataArrayType type, void *header);
+// capacity_bytes receives the usable size of the buffer (at least num_bytes)
+void * data_array_pool_alloc_buffer(size_t num_bytes, size_t *capacity_bytes);
+void data_array_pool_free_buffer(void *buffer, size_t capacity_bytes);
+
+// maps a whole file read-only; NULL if it can't be read or is empty (databin.c)
+void * map_data_array_file_readonly(const char *path, size_t *mapping_size);
+
+// writes the header of a binary array file with its data following directly after it (databin.c)
+bool write_data_array_file_header(FILE *file, DataArrayType type, int dimensions, size_t count, bool sorted);
+
+// releases a read-only file mapping of a loaded array (databin.c)
+void release_data_array_mapping(void *mapping, size_t mapping_size);
+
+// moves the data of a read-only file mapping into own memory; every library function that writes the
+// elements of an existing array in place has to call this first (datatool.c)
+void data_array1_make_writable(DataArray1 *arr);
+void data_array2_make_writable(DataArray2 *arr);
+void data_array3_make_writable(DataArray3 *arr);
+
 #endif //KMAT_DATA_ARRAY_DEF_H
@@ -0,0 +1,634 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "geometrylib_databin.h"
+#include "data_array_def.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define DATA_ARRAY_FILE_MAGIC "GLDARRAY"
+#define DATA_ARRAY_FILE_VERSION 1
+#define DATA_ARRAY_FILE_BYTE_ORDER 0x01020304u
+#define DATA_ARRAY_FILE_FLAG_SORTED 1u
+// rows of a DataArrayN written at once
+#define DATA_ARRAY_FILE_WRITE_BLOCK 4096
+
+typedef struct DataArrayFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t type;
+	uint32_t dimensions;
+	uint32_t flags;
+	uint32_t reserved0;
+	uint64_t count;
+	uint64_t data_offset;
+	uint8_t reserved[16];
+} DataArrayFileHeader;
+
+_Static_assert(sizeof(DataArrayFileHeader) == 64, "binary array file header has to be 64 bytes");
+
+
+/*
+ * ------------------------------------
+ * File Mapping
+ * ------------------------------------
+ */
+
+// reads the file into memory where mmap is not available
+void * map_data_array_file_readonly(const char *path, size_t *size) {
+#ifdef _WIN32
+	FILE *file = fopen(path, "rb");
+	if(!file) return NULL;
+	fseek(file, 0, SEEK_END);
+	long file_size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	void *mapping = file_size > 0 ? malloc(file_size) : NULL;
+	if(mapping && fread(mapping, 1, file_size, file) != (size_t) file_size) {
+		free(mapping);
+		mapping = NULL;
+	}
+	fclose(file);
+	*size = mapping ? (size_t) file_size : 0;
+	return mapping;
+#else
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) return NULL;
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return NULL;
+	}
+	void *mapping = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED) return NULL;
+	*size = (size_t) st.st_size;
+	return mapping;
+#endif
+}
+
+void release_data_array_mapping(void *mapping, size_t mapping_size) {
+	if(!mapping) return;
+#ifdef _WIN32
+	(void) mapping_size;
+	free(mapping);
+#else
+	munmap(mapping, mapping_size);
+#endif
+}
+
+
+/*
+ * ------------------------------------
+ * Header
+ * ------------------------------------
+ */
+
+static DataArrayFileHeader create_file_header(DataArrayType type, int dimensions, size_t count, bool sorted) {
+	DataArrayFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, DATA_ARRAY_FILE_MAGIC, sizeof(header.magic));
+	header.version = DATA_ARRAY_FILE_VERSION;
+	header.byte_order = DATA_ARRAY_FILE_BYTE_ORDER;
+	header.type = type;
+	header.dimensions = (uint32_t) dimensions;
+	header.flags = sorted ? DATA_ARRAY_FILE_FLAG_SORTED : 0;
+	header.count = count;
+	header.data_offset = sizeof(DataArrayFileHeader);
+	return header;
+}
+
+static bool is_valid_file_header(const DataArrayFileHeader *header, size_t file_size) {
+	if(file_size < sizeof(DataArrayFileHeader)) return false;
+	if(memcmp(header->magic, DATA_ARRAY_FILE_MAGIC, sizeof(header->magic)) != 0) return false;
+	if(header->version != DATA_ARRAY_FILE_VERSION || header->byte_order != DATA_ARRAY_FILE_BYTE_ORDER) return false;
+	if(header->type < DATA_ARRAY_TYPE_1 || header->type > DATA_ARRAY_TYPE_N || header->dimensions == 0) return false;
+	// fixed-size types are read as Vector2/Vector3, so their element size has to match
+	if(header->type != DATA_ARRAY_TYPE_N && header->dimensions != header->type) return false;
+	if(header->data_offset % sizeof(double) != 0 || header->data_offset > file_size) return false;
+	uint64_t elem_size = header->dimensions * sizeof(double);
+	return header->count <= (file_size - header->data_offset) / elem_size;
+}
+
+static DataArrayFileInfo file_info_from_header(const DataArrayFileHeader *header) {
+	return (DataArrayFileInfo) {
+		.type = (DataArrayType) header->type,
+		.dimensions = (int) header->dimensions,
+		.count = (size_t) header->count,
+		.sorted = (header->flags & DATA_ARRAY_FILE_FLAG_SORTED) != 0,
+		.data_offset = (size_t) header->data_offset
+	};
+}
+
+bool data_array_file_get_info(const char *path, DataArrayFileInfo *info) {
+	FILE *file = fopen(path, "rb");
+	if(!file) return false;
+
+	DataArrayFileHeader header;
+	bool success = fread(&header, sizeof(header), 1, file) == 1;
+	if(success) {
+		fseek(file, 0, SEEK_END);
+		long file_size = ftell(file);
+		success = file_size > 0 && is_valid_file_header(&header, (size_t) file_size);
+	}
+	fclose(file);
+
+	if(success) *info = file_info_from_header(&header);
+	return success;
+}
+
+// maps a file and checks its header; returns the header inside the mapping
+static const DataArrayFileHeader * map_data_array_file(const char *path, DataArrayType type, void **mapping, size_t *mapping_size) {
+	*mapping = map_data_array_file_readonly(path, mapping_size);
+	if(!*mapping) return NULL;
+
+	const DataArrayFileHeader *header = *mapping;
+	if(!is_valid_file_header(header, *mapping_size) || header->type != type) {
+		release_data_array_mapping(*mapping, *mapping_size);
+		*mapping = NULL;
+		return NULL;
+	}
+	return header;
+}
+
+
+/*
+ * ------------------------------------
+ * Save
+ * ------------------------------------
+ */
+
+bool write_data_array_file_header(FILE *file, DataArrayType type, int dimensions, size_t count, bool sorted) {
+	DataArrayFileHeader header = create_file_header(type, dimensions, count, sorted);
+	return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+static bool write_data_array_file(const char *path, DataArrayFileHeader header, const void *data, size_t num_bytes) {
+	FILE *file = fopen(path, "wb");
+	if(!file) return false;
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	if(success && num_bytes > 0) success = fwrite(data, 1, num_bytes, file) == num_bytes;
+	if(fclose(file) != 0) success = false;
+	return success;
+}
+
+static bool is_data_array1_sorted(DataArray1 *arr) {
+	for(size_t i = 1; i < arr->count; i++) {
+		if(arr->data[i] < arr->data[i-1]) return false;
+	}
+	return true;
+}
+
+static bool is_data_array2_sorted(DataArray2 *arr) {
+	for(size_t i = 1; i < arr->count; i++) {
+		Vector2 p0 = arr->data[i-1], p1 = arr->data[i];
+		if(p1.x < p0.x || (p1.x == p0.x && p1.y < p0.y)) return false;
+	}
+	return true;
+}
+
+static bool is_data_array3_sorted(DataArray3 *arr) {
+	for(size_t i = 1; i < arr->count; i++) {
+		Vector3 p0 = arr->data[i-1], p1 = arr->data[i];
+		if(p1.x < p0.x) return false;
+		if(p1.x == p0.x && (p1.y < p0.y || (p1.y == p0.y && p1.z < p0.z))) return false;
+	}
+	return true;
+}
+
+static bool is_data_arrayn_sorted(DataArrayN *arr) {
+	for(size_t i = 1; i < arr->count; i++) {
+		if(arr->data[i][0] < arr->data[i-1][0]) return false;
+	}
+	return true;
+}
+
+bool data_array1_save(DataArray1 *arr, const char *path) {
+	if(!arr) return false;
+	DataArrayFileHeader header = create_file_header(DATA_ARRAY_TYPE_1, 1, arr->count, is_data_array1_sorted(arr));
+	return write_data_array_file(path, header, arr->data, arr->count * sizeof(double));
+}
+
+bool data_array2_save(DataArray2 *arr, const char *path) {
+	if(!arr) return false;
+	DataArrayFileHeader header = create_file_header(DATA_ARRAY_TYPE_2, 2, arr->count, is_data_array2_sorted(arr));
+	return write_data_array_file(path, header, arr->data, arr->count * sizeof(Vector2));
+}
+
+bool data_array3_save(DataArray3 *arr, const char *path) {
+	if(!arr) return false;
+	DataArrayFileHeader header = create_file_header(DATA_ARRAY_TYPE_3, 3, arr->count, is_data_array3_sorted(arr));
+	return write_data_array_file(path, header, arr->data, arr->count * sizeof(Vector3));
+}
+
+bool data_arrayn_save(DataArrayN *arr, const char *path) {
+	if(!arr) return false;
+	DataArrayFileHeader header = create_file_header(DATA_ARRAY_TYPE_N, arr->dimensions, arr->count, is_data_arrayn_sorted(arr));
+
+	FILE *file = fopen(path, "wb");
+	if(!file) return false;
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	// rows are separate allocations -> gather them block-wise
+	size_t row_size = arr->dimensions * sizeof(double);
+	double *block = malloc(DATA_ARRAY_FILE_WRITE_BLOCK * row_size);
+	for(size_t i = 0; success && i < arr->count; i += DATA_ARRAY_FILE_WRITE_BLOCK) {
+		size_t num_rows = arr->count - i < DATA_ARRAY_FILE_WRITE_BLOCK ? arr->count - i : DATA_ARRAY_FILE_WRITE_BLOCK;
+		for(size_t j = 0; j < num_rows; j++) memcpy(block + j*arr->dimensions, arr->data[i+j], row_size);
+		success = fwrite(block, row_size, num_rows, file) == num_rows;
+	}
+	free(block);
+
+	if(fclose(file) != 0) success = false;
+	return success;
+}
+
+
+/*
+ * ------------------------------------
+ * Load
+ * ------------------------------------
+ */
+
+DataArray1 * data_array1_load(const char *path) {
+	void *mapping;
+	size_t mapping_size;
+	const DataArrayFileHeader *header = map_data_array_file(path, DATA_ARRAY_TYPE_1, &mapping, &mapping_size);
+	if(!header) return NULL;
+
+	DataArray1 *arr = data_array1_create();
+	if(header->count == 0) {
+		release_data_array_mapping(mapping, mapping_size);
+		return arr;
+	}
+	arr->data = (double *) ((char *) mapping + header->data_offset);
+	arr->count = header->count;
+	arr->capacity = header->count;
+	arr->mapping = mapping;
+	arr->mapping_size = mapping_size;
+	return arr;
+}
+
+DataArray2 * data_array2_load(const char *path) {
+	void *mapping;
+	size_t mapping_size;
+	const DataArrayFileHeader *header = map_data_array_file(path, DATA_ARRAY_TYPE_2, &mapping, &mapping_size);
+	if(!header) return NULL;
+
+	DataArray2 *arr = data_array2_create();
+	if(header->count == 0) {
+		release_data_array_mapping(mapping, mapping_size);
+		return arr;
+	}
+	arr->data = (Vector2 *) ((char *) mapping + header->data_offset);
+	arr->count = header->count;
+	arr->capacity = header->count;
+	arr->mapping = mapping;
+	arr->mapping_size = mapping_size;
+	return arr;
+}
+
+DataArray3 * data_array3_load(const char *path) {
+	void *mapping;
+	size_t mapping_size;
+	const DataArrayFileHeader *header = map_data_array_file(path, DATA_ARRAY_TYPE_3, &mapping, &mapping_size);
+	if(!header) return NULL;
+
+	DataArray3 *arr = data_array3_create();
+	if(header->count == 0) {
+		release_data_array_mapping(mapping, mapping_size);
+		return arr;
+	}
+	arr->data = (Vector3 *) ((char *) mapping + header->data_offset);
+	arr->count = header->count;
+	arr->capacity = header->count;
+	arr->mapping = mapping;
+	arr->mapping_size = mapping_size;
+	return arr;
+}
+
+DataArrayN * data_arrayn_load(const char *path) {
+	void *mapping;
+	size_t mapping_size;
+	const DataArrayFileHeader *header = map_data_array_file(path, DATA_ARRAY_TYPE_N, &mapping, &mapping_size);
+	if(!header) return NULL;
+
+	int dimensions = (int) header->dimensions;
+	DataArrayN *arr = data_arrayn_create(dimensions);
+	data_arrayn_reserve(arr, header->count);
+	const double *values = (const double *) ((const char *) mapping + header->data_offset);
+	for(size_t i = 0; i < header->count; i++) memcpy(arr->data[i], values + i*dimensions, dimensions * sizeof(double));
+	arr->count = header->count;
+
+	release_data_array_mapping(mapping, mapping_size);
+	return arr;
+}
+
+
+/*
+ * ------------------------------------
+ * NumPy Files
+ * ------------------------------------
+ */
+
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_LENGTH 6
+// the data of written files starts at a multiple of this (as numpy does it)
+#define NPY_HEADER_ALIGNMENT 64
+
+typedef enum NpyDataType {
+	NPY_FLOAT64,
+	NPY_FLOAT32,
+	NPY_INT64,
+	NPY_INT32
+} NpyDataType;
+
+typedef struct NpyHeader {
+	NpyDataType data_type;
+	bool native_byte_order;
+	bool fortran_order;
+	int num_dims;
+	size_t shape[2];
+	size_t data_offset;
+} NpyHeader;
+
+static bool is_little_endian_host() {
+	uint16_t value = 1;
+	uint8_t first_byte;
+	memcpy(&first_byte, &value, 1);
+	return first_byte == 1;
+}
+
+static bool write_npy(const char *path, size_t rows, int cols, bool one_dimensional, const double *interleaved, double **row_ptrs) {
+	char dict[128];
+	int dict_length = one_dimensional ?
+		snprintf(dict, sizeof(dict), "{'descr': '%cf8', 'fortran_order': False, 'shape': (%zu,), }", is_little_endian_host() ? '<' : '>', rows) :
+		snprintf(dict, sizeof(dict), "{'descr': '%cf8', 'fortran_order': False, 'shape': (%zu, %d), }", is_little_endian_host() ? '<' : '>', rows, cols);
+
+	// magic, version 1.0, header length, dict padded with spaces and terminated with a newline
+	size_t header_size = NPY_MAGIC_LENGTH + 4 + dict_length + 1;
+	header_size = (header_size + NPY_HEADER_ALIGNMENT-1) / NPY_HEADER_ALIGNMENT * NPY_HEADER_ALIGNMENT;
+	char header[256];
+	memset(header, ' ', header_size);
+	memcpy(header, NPY_MAGIC, NPY_MAGIC_LENGTH);
+	header[6] = 1;
+	header[7] = 0;
+	uint16_t header_length = (uint16_t) (header_size - NPY_MAGIC_LENGTH - 4);
+	header[8] = (char) (header_length & 0xFF);
+	header[9] = (char) (header_length >> 8);
+	memcpy(header + NPY_MAGIC_LENGTH + 4, dict, dict_length);
+	header[header_size-1] = '\n';
+
+	FILE *file = fopen(path, "wb");
+	if(!file) return false;
+	bool success = fwrite(header, 1, header_size, file) == header_size;
+	if(interleaved) {
+		if(success && rows > 0) success = fwrite(interleaved, cols * sizeof(double), rows, file) == rows;
+	} else {
+		for(size_t i = 0; success && i < rows; i++) success = fwrite(row_ptrs[i], sizeof(double), cols, file) == (size_t) cols;
+	}
+	if(fclose(file) != 0) success = false;
+	return success;
+}
+
+bool data_array1_save_npy(DataArray1 *arr, const char *path) {
+	if(!arr) return false;
+	return write_npy(path, arr->count, 1, true, arr->data, NULL);
+}
+
+bool data_array2_save_npy(DataArray2 *arr, const char *path) {
+	if(!arr) return false;
+	return write_npy(path, arr->count, 2, false, (const double *) arr->data, NULL);
+}
+
+bool data_array3_save_npy(DataArray3 *arr, const char *path) {
+	if(!arr) return false;
+	return write_npy(path, arr->count, 3, false, (const double *) arr->data, NULL);
+}
+
+bool data_arrayn_save_npy(DataArrayN *arr, const char *path) {
+	if(!arr) return false;
+	return write_npy(path, arr->count, arr->dimensions, false, NULL, arr->data);
+}
+
+// returns the position after "'key':" in the header dict (NULL if missing)
+static const char * find_npy_key(const char *dict, const char *dict_end, const char *key) {
+	size_t key_length = strlen(key);
+	for(const char *p = dict; p + key_length + 2 < dict_end; p++) {
+		if((*p == '\'' || *p == '"') && p[key_length+1] == *p && memcmp(p+1, key, key_length) == 0) {
+			p += key_length + 2;
+			while(p < dict_end && (*p == ' ' || *p == ':')) p++;
+			return p;
+		}
+	}
+	return NULL;
+}
+
+static bool parse_npy_header(const uint8_t *file_data, size_t file_size, NpyHeader *header) {
+	if(file_size < NPY_MAGIC_LENGTH + 4 || memcmp(file_data, NPY_MAGIC, NPY_MAGIC_LENGTH) != 0) return false;
+	int major_version = file_data[6];
+	size_t dict_offset, dict_length;
+	if(major_version == 1) {
+		dict_offset = NPY_MAGIC_LENGTH + 4;
+		dict_length = file_data[8] | (size_t) file_data[9] << 8;
+	} else if(major_version == 2 || major_version == 3) {
+		if(file_size < NPY_MAGIC_LENGTH + 6) return false;
+		dict_offset = NPY_MAGIC_LENGTH + 6;
+		dict_length = file_data[8] | (size_t) file_data[9] << 8 | (size_t) file_data[10] << 16 | (size_t) file_data[11] << 24;
+	} else {
+		return false;
+	}
+	if(dict_offset + dict_length > file_size) return false;
+	const char *dict = (const char *) file_data + dict_offset;
+	const char *dict_end = dict + dict_length;
+	header->data_offset = dict_offset + dict_length;
+
+	const char *descr = find_npy_key(dict, dict_end, "descr");
+	if(!descr || descr + 5 > dict_end) return false;
+	char byte_order = descr[1];
+	if(byte_order == '<') header->native_byte_order = is_little_endian_host();
+	else if(byte_order == '>') header->native_byte_order = !is_little_endian_host();
+	else header->native_byte_order = byte_order == '=' || byte_order == '|';
+	if(memcmp(descr+2, "f8", 2) == 0) header->data_type = NPY_FLOAT64;
+	else if(memcmp(descr+2, "f4", 2) == 0) header->data_type = NPY_FLOAT32;
+	else if(memcmp(descr+2, "i8", 2) == 0) header->data_type = NPY_INT64;
+	else if(memcmp(descr+2, "i4", 2) == 0) header->data_type = NPY_INT32;
+	else return false;
+	if(descr[4] != descr[0]) return false;
+
+	const char *fortran_order = find_npy_key(dict, dict_end, "fortran_order");
+	if(!fortran_order) return false;
+	header->fortran_order = *fortran_order == 'T';
+
+	const char *shape = find_npy_key(dict, dict_end, "shape");
+	if(!shape || *shape != '(') return false;
+	header->num_dims = 0;
+	const char *p = shape + 1;
+	while(p < dict_end && *p != ')') {
+		if(*p >= '0' && *p <= '9') {
+			if(header->num_dims == 2) return false;
+			char *end;
+			header->shape[header->num_dims++] = strtoull(p, &end, 10);
+			p = end;
+		} else {
+			p++;
+		}
+	}
+	if(header->num_dims == 0) return false;
+	if(header->num_dims == 1) header->shape[1] = 1;
+	return true;
+}
+
+static size_t npy_element_size(NpyDataType data_type) {
+	return data_type == NPY_FLOAT64 || data_type == NPY_INT64 ? 8 : 4;
+}
+
+static double npy_read_value(const uint8_t *data, NpyDataType data_type, bool native_byte_order) {
+	uint8_t bytes[8];
+	size_t size = npy_element_size(data_type);
+	for(size_t i = 0; i < size; i++) bytes[i] = native_byte_order ? data[i] : data[size-1-i];
+	switch(data_type) {
+		case NPY_FLOAT64: { double value; memcpy(&value, bytes, 8); return value; }
+		case NPY_FLOAT32: { float value; memcpy(&value, bytes, 4); return value; }
+		case NPY_INT64: { int64_t value; memcpy(&value, bytes, 8); return (double) value; }
+		default: { int32_t value; memcpy(&value, bytes, 4); return value; }
+	}
+}
+
+/*
+ * Maps an .npy file and checks that it holds a (rows, cols) array (or (rows,) if cols is 1).
+ * Returns true with zero_copy set if the data can be used in place (native float64, C order, aligned).
+ */
+static bool map_npy_file(const char *path, int cols, NpyHeader *header, void **mapping, size_t *mapping_size, bool *zero_copy) {
+	*mapping = map_data_array_file_readonly(path, mapping_size);
+	if(!*mapping) return false;
+
+	bool valid = parse_npy_header(*mapping, *mapping_size, header);
+	if(valid && cols > 0) valid = header->shape[1] == (size_t) cols && (header->num_dims == 2 || cols == 1);
+	if(valid) {
+		// bounded by division, so huge shapes can not wrap around
+		size_t elem_size = npy_element_size(header->data_type);
+		size_t row_size = header->shape[1] <= SIZE_MAX / elem_size ? header->shape[1] * elem_size : 0;
+		valid = header->data_offset <= *mapping_size && row_size != 0 &&
+			header->shape[0] <= (*mapping_size - header->data_offset) / row_size;
+	}
+	if(!valid) {
+		release_data_array_mapping(*mapping, *mapping_size);
+		return false;
+	}
+	*zero_copy = header->data_type == NPY_FLOAT64 && header->native_byte_order &&
+		(!header->fortran_order || header->shape[1] == 1) && header->data_offset % sizeof(double) == 0;
+	return true;
+}
+
+// converts the elements of an npy file into row-major doubles
+static void copy_npy_values(const void *mapping, const NpyHeader *header, double *dst) {
+	const uint8_t *data = (const uint8_t *) mapping + header->data_offset;
+	size_t rows = header->shape[0], cols = header->shape[1];
+	size_t elem_size = npy_element_size(header->data_type);
+	for(size_t i = 0; i < rows; i++) {
+		for(size_t c = 0; c < cols; c++) {
+			size_t src_idx = header->fortran_order ? c*rows + i : i*cols + c;
+			dst[i*cols + c] = npy_read_value(data + src_idx*elem_size, header->data_type, header->native_byte_order);
+		}
+	}
+}
+
+DataArray1 * data_array1_load_npy(const char *path) {
+	NpyHeader header;
+	void *mapping;
+	size_t mapping_size;
+	bool zero_copy;
+	if(!map_npy_file(path, 1, &header, &mapping, &mapping_size, &zero_copy)) return NULL;
+
+	DataArray1 *arr = data_array1_create();
+	if(zero_copy && header.shape[0] > 0) {
+		arr->data = (double *) ((char *) mapping + header.data_offset);
+		arr->count = header.shape[0];
+		arr->capacity = header.shape[0];
+		arr->mapping = mapping;
+		arr->mapping_size = mapping_size;
+		return arr;
+	}
+	data_array1_reserve(arr, header.shape[0]);
+	copy_npy_values(mapping, &header, arr->data);
+	arr->count = header.shape[0];
+	release_data_array_mapping(mapping, mapping_size);
+	return arr;
+}
+
+DataArray2 * data_array2_load_npy(const char *path) {
+	NpyHeader header;
+	void *mapping;
+	size_t mapping_size;
+	bool zero_copy;
+	if(!map_npy_file(path, 2, &header, &mapping, &mapping_size, &zero_copy)) return NULL;
+
+	DataArray2 *arr = data_array2_create();
+	if(zero_copy && header.shape[0] > 0) {
+		arr->data = (Vector2 *) ((char *) mapping + header.data_offset);
+		arr->count = header.shape[0];
+		arr->capacity = header.shape[0];
+		arr->mapping = mapping;
+		arr->mapping_size = mapping_size;
+		return arr;
+	}
+	data_array2_reserve(arr, header.shape[0]);
+	copy_npy_values(mapping, &header, (double *) arr->data);
+	arr->count = header.shape[0];
+	release_data_array_mapping(mapping, mapping_size);
+	return arr;
+}
+
+DataArray3 * data_array3_load_npy(const char *path) {
+	NpyHeader header;
+	void *mapping;
+	size_t mapping_size;
+	bool zero_copy;
+	if(!map_npy_file(path, 3, &header, &mapping, &mapping_size, &zero_copy)) return NULL;
+
+	DataArray3 *arr = data_array3_create();
+	if(zero_copy && header.shape[0] > 0) {
+		arr->data = (Vector3 *) ((char *) mapping + header.data_offset);
+		arr->count = header.shape[0];
+		arr->capacity = header.shape[0];
+		arr->mapping = mapping;
+		arr->mapping_size = mapping_size;
+		return arr;
+	}
+	data_array3_reserve(arr, header.shape[0]);
+	copy_npy_values(mapping, &header, (double *) arr->data);
+	arr->count = header.shape[0];
+	release_data_array_mapping(mapping, mapping_size);
+	return arr;
+}
+
+DataArrayN * data_arrayn_load_npy(const char *path) {
+	NpyHeader header;
+	void *mapping;
+	size_t mapping_size;
+	bool zero_copy;
+	if(!map_npy_file(path, 0, &header, &mapping, &mapping_size, &zero_copy)) return NULL;
+	if(header.shape[1] == 0 || header.shape[1] > INT32_MAX) {
+		release_data_array_mapping(mapping, mapping_size);
+		return NULL;
+	}
+
+	int dimensions = (int) header.shape[1];
+	DataArrayN *arr = data_arrayn_create(dimensions);
+	data_arrayn_reserve(arr, header.shape[0]);
+	double *values = malloc((header.shape[0] > 0 ? header.shape[0] : 1) * dimensions * sizeof(double));
+	copy_npy_values(mapping, &header, values);
+	for(size_t i = 0; i < header.shape[0]; i++) memcpy(arr->data[i], values + i*dimensions, dimensions * sizeof(double));
+	arr->count = header.shape[0];
+	free(values);
+	release_data_array_mapping(mapping, mapping_size);
+	return arr;
+}
@@ -0,0 +1,578 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "geometrylib_datacompress.h"
+#include "data_array_def.h"
+#include "parallel.h"
+
+#define COMPRESSED_DEFAULT_BLOCK_SIZE 1024
+// zero bytes behind the compressed data so that the bit reader can always load 8 bytes
+#define COMPRESSED_PADDING 8
+// longest encoding of one element: '1111' + 64 bits of x, '11' + 5 + 6 + 64 bits of y
+#define COMPRESSED_MAX_ELEMENT_BITS 145
+#define COMPRESSED_FILE_MAGIC "GLDARRGZ"
+#define COMPRESSED_FILE_VERSION 1
+
+typedef struct CompressedBlock2 {
+	double first_x;
+	double first_y;
+	double last_x;
+	uint64_t offset;	// byte offset of the block in the compressed data
+	uint64_t count;
+} CompressedBlock2;
+
+struct CompressedDataArray2 {
+	uint8_t *data;
+	size_t num_bytes;
+	CompressedBlock2 *blocks;
+	size_t num_blocks;
+	size_t count;
+	size_t block_size;
+};
+
+typedef struct CompressedFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t count;
+	uint64_t block_size;
+	uint64_t num_blocks;
+	uint64_t num_bytes;
+} CompressedFileHeader;
+
+
+/*
+ * ------------------------------------
+ * Bit Streams
+ * ------------------------------------
+ */
+
+typedef struct BitWriter {
+	uint8_t *data;
+	size_t num_bytes;
+	size_t capacity;
+	uint64_t acc;
+	int num_acc_bits;
+} BitWriter;
+
+typedef struct BitReader {
+	const uint8_t *data;
+	size_t bit_pos;
+} BitReader;
+
+static void bit_writer_push_byte(BitWriter *writer, uint8_t byte) {
+	if(writer->num_bytes == writer->capacity) {
+		writer->capacity = writer->capacity ? writer->capacity*2 : 4096;
+		writer->data = realloc(writer->data, writer->capacity);
+	}
+	writer->data[writer->num_bytes++] = byte;
+}
+
+// writes the lowest num_bits (1-64) bits of value, most significant first
+static void bit_writer_write(BitWriter *writer, uint64_t value, int num_bits) {
+	if(num_bits > 32) {
+		bit_writer_write(writer, value >> 32, num_bits - 32);
+		num_bits = 32;
+	}
+	writer->acc = (writer->acc << num_bits) | (value & (0xFFFFFFFFFFFFFFFFull >> (64 - num_bits)));
+	writer->num_acc_bits += num_bits;
+	while(writer->num_acc_bits >= 8) {
+		writer->num_acc_bits -= 8;
+		bit_writer_push_byte(writer, (uint8_t) (writer->acc >> writer->num_acc_bits));
+	}
+}
+
+static void bit_writer_align(BitWriter *writer) {
+	if(writer->num_acc_bits > 0) bit_writer_push_byte(writer, (uint8_t) (writer->acc << (8 - writer->num_acc_bits)));
+	writer->acc = 0;
+	writer->num_acc_bits = 0;
+}
+
+static inline uint64_t load_u64_big_endian(const uint8_t *p) {
+	uint64_t value;
+	memcpy(&value, p, sizeof(value));
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	return __builtin_bswap64(value);
+#else
+	value = 0;
+	for(int i = 0; i < 8; i++) value = (value << 8) | p[i];
+	return value;
+#endif
+}
+
+// reads num_bits (1-56) bits
+static inline uint64_t bit_reader_read(BitReader *reader, int num_bits) {
+	uint64_t word = load_u64_big_endian(reader->data + (reader->bit_pos >> 3));
+	uint64_t value = (word << (reader->bit_pos & 7)) >> (64 - num_bits);
+	reader->bit_pos += num_bits;
+	return value;
+}
+
+// reads num_bits (1-64) bits
+static inline uint64_t bit_reader_read_long(BitReader *reader, int num_bits) {
+	if(num_bits <= 56) return bit_reader_read(reader, num_bits);
+	uint64_t high = bit_reader_read(reader, num_bits - 32);
+	return (high << 32) | bit_reader_read(reader, 32);
+}
+
+
+/*
+ * ------------------------------------
+ * Gorilla Encoding
+ * ------------------------------------
+ */
+
+/*
+ * x: delta-of-delta of its bit pattern mapped to an unsigned integer that is monotonic in x
+ *    (uniformly spaced x within one power of two have constant deltas -> mostly a single 0 bit)
+ *    '0' dod = 0 | '10' 7 bits | '110' 9 bits | '1110' 12 bits | '1111' 64 bits
+ * y: XOR with the previous y
+ *    '0' equal | '10' meaningful bits inside the previous window | '11' 5 bits leading zeros, 6 bits length-1, bits
+ */
+
+typedef struct GorillaState {
+	uint64_t x_prev;
+	uint64_t delta_prev;
+	uint64_t y_prev;
+	int leading_zeros;
+	int trailing_zeros;
+} GorillaState;
+
+static inline uint64_t double_to_bits(double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static inline double bits_to_double(uint64_t bits) {
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static inline uint64_t ordered_from_double(double value) {
+	uint64_t bits = double_to_bits(value);
+	return (bits >> 63) ? ~bits : bits | 0x8000000000000000ull;
+}
+
+static inline double double_from_ordered(uint64_t ordered) {
+	return bits_to_double((ordered >> 63) ? ordered & 0x7FFFFFFFFFFFFFFFull : ~ordered);
+}
+
+static inline int count_leading_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(x);
+#else
+	int n = 0;
+	while(!(x & 0x8000000000000000ull)) { x <<= 1; n++; }
+	return n;
+#endif
+}
+
+static inline int count_trailing_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int n = 0;
+	while(!(x & 1)) { x >>= 1; n++; }
+	return n;
+#endif
+}
+
+static void gorilla_encode_x(BitWriter *writer, GorillaState *state, uint64_t x) {
+	uint64_t delta = x - state->x_prev;
+	int64_t dod = (int64_t) (delta - state->delta_prev);
+	if(dod == 0) {
+		bit_writer_write(writer, 0, 1);
+	} else if(dod >= -63 && dod <= 64) {
+		bit_writer_write(writer, 0x2, 2);
+		bit_writer_write(writer, (uint64_t) (dod + 63), 7);
+	} else if(dod >= -255 && dod <= 256) {
+		bit_writer_write(writer, 0x6, 3);
+		bit_writer_write(writer, (uint64_t) (dod + 255), 9);
+	} else if(dod >= -2047 && dod <= 2048) {
+		bit_writer_write(writer, 0xE, 4);
+		bit_writer_write(writer, (uint64_t) (dod + 2047), 12);
+	} else {
+		bit_writer_write(writer, 0xF, 4);
+		bit_writer_write(writer, (uint64_t) dod, 64);
+	}
+	state->delta_prev = delta;
+	state->x_prev = x;
+}
+
+static void gorilla_encode_y(BitWriter *writer, GorillaState *state, uint64_t y) {
+	uint64_t xor = y ^ state->y_prev;
+	state->y_prev = y;
+	if(xor == 0) {
+		bit_writer_write(writer, 0, 1);
+		return;
+	}
+	int leading_zeros = count_leading_zeros(xor);
+	int trailing_zeros = count_trailing_zeros(xor);
+	if(leading_zeros > 31) leading_zeros = 31;
+
+	if(state->leading_zeros >= 0 && leading_zeros >= state->leading_zeros && trailing_zeros >= state->trailing_zeros) {
+		bit_writer_write(writer, 0x2, 2);
+		bit_writer_write(writer, xor >> state->trailing_zeros, 64 - state->leading_zeros - state->trailing_zeros);
+	} else {
+		int num_meaningful = 64 - leading_zeros - trailing_zeros;
+		bit_writer_write(writer, 0x3, 2);
+		bit_writer_write(writer, (uint64_t) leading_zeros, 5);
+		bit_writer_write(writer, (uint64_t) (num_meaningful - 1), 6);
+		bit_writer_write(writer, xor >> trailing_zeros, num_meaningful);
+		state->leading_zeros = leading_zeros;
+		state->trailing_zeros = trailing_zeros;
+	}
+}
+
+static inline double gorilla_decode_x(BitReader *reader, GorillaState *state) {
+	int64_t dod;
+	if(bit_reader_read(reader, 1) == 0) {
+		dod = 0;
+	} else if(bit_reader_read(reader, 1) == 0) {
+		dod = (int64_t) bit_reader_read(reader, 7) - 63;
+	} else if(bit_reader_read(reader, 1) == 0) {
+		dod = (int64_t) bit_reader_read(reader, 9) - 255;
+	} else if(bit_reader_read(reader, 1) == 0) {
+		dod = (int64_t) bit_reader_read(reader, 12) - 2047;
+	} else {
+		dod = (int64_t) bit_reader_read_long(reader, 64);
+	}
+	state->delta_prev += (uint64_t) dod;
+	state->x_prev += state->delta_prev;
+	return double_from_ordered(state->x_prev);
+}
+
+static inline double gorilla_decode_y(BitReader *reader, GorillaState *state) {
+	if(bit_reader_read(reader, 1) == 0) return bits_to_double(state->y_prev);
+
+	if(bit_reader_read(reader, 1) == 1) {
+		state->leading_zeros = (int) bit_reader_read(reader, 5);
+		state->trailing_zeros = 64 - state->leading_zeros - ((int) bit_reader_read(reader, 6) + 1);
+	}
+	int num_meaningful = 64 - state->leading_zeros - state->trailing_zeros;
+	state->y_prev ^= bit_reader_read_long(reader, num_meaningful) << state->trailing_zeros;
+	return bits_to_double(state->y_prev);
+}
+
+
+/*
+ * ------------------------------------
+ * Blocks
+ * ------------------------------------
+ */
+
+// sequential decoder of the elements of one block
+typedef struct BlockDecoder {
+	BitReader reader;
+	GorillaState state;
+	size_t remaining;
+	bool first;
+} BlockDecoder;
+
+static BlockDecoder block_decoder_create(CompressedDataArray2 *carr, size_t block_idx) {
+	BlockDecoder decoder = {
+		.reader = {.data = carr->data + carr->blocks[block_idx].offset, .bit_pos = 0},
+		.state = {0},
+		.remaining = carr->blocks[block_idx].count,
+		.first = true
+	};
+	return decoder;
+}
+
+static inline Vector2 block_decoder_next(BlockDecoder *decoder) {
+	decoder->remaining--;
+	if(decoder->first) {
+		decoder->first = false;
+		decoder->state.x_prev = bit_reader_read_long(&decoder->reader, 64);
+		decoder->state.y_prev = bit_reader_read_long(&decoder->reader, 64);
+		decoder->state.leading_zeros = -1;
+		return vec2(double_from_ordered(decoder->state.x_prev), bits_to_double(decoder->state.y_prev));
+	}
+	double x = gorilla_decode_x(&decoder->reader, &decoder->state);
+	double y = gorilla_decode_y(&decoder->reader, &decoder->state);
+	return vec2(x, y);
+}
+
+static void encode_block(BitWriter *writer, const Vector2 *data, size_t count) {
+	GorillaState state = {0};
+	state.x_prev = ordered_from_double(data[0].x);
+	state.y_prev = double_to_bits(data[0].y);
+	state.leading_zeros = -1;
+	bit_writer_write(writer, state.x_prev, 64);
+	bit_writer_write(writer, state.y_prev, 64);
+	for(size_t i = 1; i < count; i++) {
+		gorilla_encode_x(writer, &state, ordered_from_double(data[i].x));
+		gorilla_encode_y(writer, &state, double_to_bits(data[i].y));
+	}
+	bit_writer_align(writer);
+}
+
+static void decode_block(CompressedDataArray2 *carr, size_t block_idx, Vector2 *dst) {
+	BlockDecoder decoder = block_decoder_create(carr, block_idx);
+	size_t count = decoder.remaining;
+	for(size_t i = 0; i < count; i++) dst[i] = block_decoder_next(&decoder);
+}
+
+
+/*
+ * ------------------------------------
+ * Create and Free
+ * ------------------------------------
+ */
+
+static CompressedDataArray2 * compressed_data_array2_alloc(size_t count, size_t block_size, size_t num_blocks) {
+	CompressedDataArray2 *carr = malloc(sizeof(CompressedDataArray2));
+	carr->data = NULL;
+	carr->num_bytes = 0;
+	carr->blocks = malloc((num_blocks > 0 ? num_blocks : 1) * sizeof(CompressedBlock2));
+	carr->num_blocks = num_blocks;
+	carr->count = count;
+	carr->block_size = block_size;
+	return carr;
+}
+
+CompressedDataArray2 * compressed_data_array2_create(DataArray2 *arr, size_t block_size) {
+	if(!arr) return NULL;
+	if(block_size == 0) block_size = COMPRESSED_DEFAULT_BLOCK_SIZE;
+	size_t num_blocks = (arr->count + block_size - 1) / block_size;
+	CompressedDataArray2 *carr = compressed_data_array2_alloc(arr->count, block_size, num_blocks);
+
+	BitWriter writer = {0};
+	for(size_t b = 0; b < num_blocks; b++) {
+		size_t begin = b * block_size;
+		size_t count = arr->count - begin < block_size ? arr->count - begin : block_size;
+		carr->blocks[b] = (CompressedBlock2) {
+			.first_x = arr->data[begin].x,
+			.first_y = arr->data[begin].y,
+			.last_x = arr->data[begin + count-1].x,
+			.offset = writer.num_bytes,
+			.count = count
+		};
+		encode_block(&writer, arr->data + begin, count);
+	}
+	for(int i = 0; i < COMPRESSED_PADDING; i++) bit_writer_push_byte(&writer, 0);
+
+	carr->data = writer.data;
+	carr->num_bytes = writer.num_bytes - COMPRESSED_PADDING;
+	return carr;
+}
+
+void compressed_data_array2_free(CompressedDataArray2 *carr) {
+	if(!carr) return;
+	free(carr->data);
+	free(carr->blocks);
+	free(carr);
+}
+
+
+/*
+ * ------------------------------------
+ * Properties
+ * ------------------------------------
+ */
+
+size_t compressed_data_array2_size(CompressedDataArray2 *carr) {
+	return carr ? carr->count : 0;
+}
+
+size_t compressed_data_array2_num_blocks(CompressedDataArray2 *carr) {
+	return carr ? carr->num_blocks : 0;
+}
+
+size_t compressed_data_array2_num_bytes(CompressedDataArray2 *carr) {
+	return carr ? carr->num_bytes : 0;
+}
+
+
+/*
+ * ------------------------------------
+ * Decompression and Access
+ * ------------------------------------
+ */
+
+typedef struct DecompressJob {
+	CompressedDataArray2 *carr;
+	Vector2 *dst;
+	size_t num_blocks_per_task;
+} DecompressJob;
+
+static void decompress_blocks_task(void *ctx, size_t task_idx) {
+	DecompressJob *job = ctx;
+	size_t begin = task_idx * job->num_blocks_per_task;
+	size_t end = begin + job->num_blocks_per_task;
+	if(end > job->carr->num_blocks) end = job->carr->num_blocks;
+	for(size_t b = begin; b < end; b++) decode_block(job->carr, b, job->dst + b * job->carr->block_size);
+}
+
+DataArray2 * compressed_data_array2_decompress(CompressedDataArray2 *carr) {
+	if(!carr) return NULL;
+	DataArray2 *arr = data_array2_create();
+	data_array2_reserve(arr, carr->count);
+
+	size_t num_tasks = get_num_parallel_chunks(carr->count, DATA_ARRAY_PARALLEL_MIN_CHUNK);
+	if(num_tasks > carr->num_blocks) num_tasks = carr->num_blocks;
+	if(num_tasks > 0) {
+		DecompressJob job = {.carr = carr, .dst = arr->data, .num_blocks_per_task = (carr->num_blocks + num_tasks - 1) / num_tasks};
+		if(num_tasks == 1) decompress_blocks_task(&job, 0);
+		else run_parallel_tasks(num_tasks, decompress_blocks_task, &job);
+	}
+	arr->count = carr->count;
+	return arr;
+}
+
+size_t compressed_data_array2_decompress_block(CompressedDataArray2 *carr, size_t block_idx, DataArray2 *dst) {
+	if(!carr || !dst || block_idx >= carr->num_blocks) return 0;
+	size_t count = carr->blocks[block_idx].count;
+	if(dst->mapping) data_array2_clear(dst);
+	data_array2_reserve(dst, count);
+	decode_block(carr, block_idx, dst->data);
+	dst->count = count;
+	data_array2_invalidate_cache(dst);
+	return count;
+}
+
+Vector2 compressed_data_array2_get(CompressedDataArray2 *carr, size_t idx) {
+	if(!carr || idx >= carr->count) return vec2(NAN, NAN);
+	BlockDecoder decoder = block_decoder_create(carr, idx / carr->block_size);
+	Vector2 p = block_decoder_next(&decoder);
+	for(size_t i = 0; i < idx % carr->block_size; i++) p = block_decoder_next(&decoder);
+	return p;
+}
+
+int compressed_data_array2_find_block(CompressedDataArray2 *carr, double x) {
+	if(!carr || carr->num_blocks == 0) return -1;
+	if(x < carr->blocks[0].first_x || x > carr->blocks[carr->num_blocks-1].last_x) return -1;
+
+	size_t idx0 = 0, idx1 = carr->num_blocks;
+	while(idx1 - idx0 > 1) {
+		size_t idx_m = (idx0 + idx1)/2;
+		if(carr->blocks[idx_m].first_x <= x) idx0 = idx_m;
+		else idx1 = idx_m;
+	}
+	return (int) idx0;
+}
+
+double compressed_data_array2_interpolate(CompressedDataArray2 *carr, double x) {
+	int block_idx = compressed_data_array2_find_block(carr, x);
+	if(block_idx < 0) return NAN;
+
+	BlockDecoder decoder = block_decoder_create(carr, block_idx);
+	Vector2 p0 = block_decoder_next(&decoder);
+	if(p0.x == x) return p0.y;
+	while(decoder.remaining > 0) {
+		Vector2 p1 = block_decoder_next(&decoder);
+		if(p1.x >= x) return (x-p0.x) * (p1.y-p0.y) / (p1.x-p0.x) + p0.y;
+		p0 = p1;
+	}
+
+	// x lies between the last element of this block and the first of the next one
+	CompressedBlock2 *next = &carr->blocks[block_idx+1];
+	return (x-p0.x) * (next->first_y-p0.y) / (next->first_x-p0.x) + p0.y;
+}
+
+
+/*
+ * ------------------------------------
+ * Files
+ * ------------------------------------
+ */
+
+bool compressed_data_array2_save(CompressedDataArray2 *carr, const char *path) {
+	if(!carr) return false;
+	FILE *file = fopen(path, "wb");
+	if(!file) return false;
+
+	CompressedFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, COMPRESSED_FILE_MAGIC, sizeof(header.magic));
+	header.version = COMPRESSED_FILE_VERSION;
+	header.count = carr->count;
+	header.block_size = carr->block_size;
+	header.num_blocks = carr->num_blocks;
+	header.num_bytes = carr->num_bytes;
+
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	if(success && carr->num_blocks > 0) success = fwrite(carr->blocks, sizeof(CompressedBlock2), carr->num_blocks, file) == carr->num_blocks;
+	if(success && carr->num_bytes > 0) success = fwrite(carr->data, 1, carr->num_bytes, file) == carr->num_bytes;
+	if(fclose(file) != 0) success = false;
+	return success;
+}
+
+// decodes a block from a zero-padded copy of its bytes (scratch), so even a corrupt block is never read
+// past the copy; the block is valid if decoding all of its elements stays within its bytes
+static bool is_compressed_block_within(CompressedDataArray2 *carr, size_t block_idx, size_t end, uint8_t *scratch) {
+	CompressedBlock2 *block = &carr->blocks[block_idx];
+	size_t num_bytes = end - block->offset;
+	memcpy(scratch, carr->data + block->offset, num_bytes);
+	memset(scratch + num_bytes, 0, COMPRESSED_MAX_ELEMENT_BITS/8 + 2*COMPRESSED_PADDING);
+	BlockDecoder decoder = {.reader = {.data = scratch, .bit_pos = 0}, .remaining = block->count, .first = true};
+	while(decoder.remaining > 0) {
+		block_decoder_next(&decoder);
+		if(decoder.reader.bit_pos > num_bytes * 8) return false;
+	}
+	return true;
+}
+
+static bool are_compressed_blocks_valid(CompressedDataArray2 *carr) {
+	size_t count = 0;
+	for(size_t b = 0; b < carr->num_blocks; b++) {
+		CompressedBlock2 *block = &carr->blocks[b];
+		if(block->offset >= carr->num_bytes || block->count == 0 || block->count > carr->block_size) return false;
+		if(b + 1 < carr->num_blocks && (block->count != carr->block_size || carr->blocks[b+1].offset <= block->offset)) return false;
+		count += block->count;
+	}
+	if(count != carr->count) return false;
+
+	// a block ends where the next one starts (the last one at the end of the data)
+	uint8_t *scratch = malloc(carr->num_bytes + COMPRESSED_MAX_ELEMENT_BITS/8 + 2*COMPRESSED_PADDING);
+	bool valid = true;
+	for(size_t b = 0; valid && b < carr->num_blocks; b++) {
+		size_t end = b + 1 < carr->num_blocks ? carr->blocks[b+1].offset : carr->num_bytes;
+		valid = is_compressed_block_within(carr, b, end, scratch);
+	}
+	free(scratch);
+	return valid;
+}
+
+CompressedDataArray2 * compressed_data_array2_load(const char *path) {
+	FILE *file = fopen(path, "rb");
+	if(!file) return NULL;
+
+	CompressedFileHeader header;
+	bool success = fread(&header, sizeof(header), 1, file) == 1;
+	success = success && memcmp(header.magic, COMPRESSED_FILE_MAGIC, sizeof(header.magic)) == 0;
+	success = success && header.version == COMPRESSED_FILE_VERSION && header.block_size > 0;
+	success = success && header.num_blocks == header.count / header.block_size + (header.count % header.block_size != 0);
+	if(success) {
+		// sizes have to fit the file before anything gets allocated (compared without overflowing products)
+		long header_end = ftell(file);
+		fseek(file, 0, SEEK_END);
+		long file_size = ftell(file);
+		success = header_end >= 0 && file_size >= header_end;
+		uint64_t available = success ? (uint64_t) (file_size - header_end) : 0;
+		success = success && header.num_blocks <= available / sizeof(CompressedBlock2) &&
+			header.num_bytes == available - header.num_blocks * sizeof(CompressedBlock2);
+		fseek(file, header_end, SEEK_SET);
+	}
+	if(!success) {
+		fclose(file);
+		return NULL;
+	}
+
+	CompressedDataArray2 *carr = compressed_data_array2_alloc(header.count, header.block_size, header.num_blocks);
+	carr->num_bytes = header.num_bytes;
+	carr->data = calloc(carr->num_bytes + COMPRESSED_PADDING, 1);
+	if(carr->num_blocks > 0) success = fread(carr->blocks, sizeof(CompressedBlock2), carr->num_blocks, file) == carr->num_blocks;
+	if(success && carr->num_bytes > 0) success = fread(carr->data, 1, carr->num_bytes, file) == carr->num_bytes;
+	fclose(file);
+
+	if(!success || !are_compressed_blocks_valid(carr)) {
+		compressed_data_array2_free(carr);
+		return NULL;
+	}
+	return carr;
+}
@@ -0,0 +1,275 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "geometrylib_datatool.h"
+#include "data_array_def.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+// headers kept per array type and thread
+#define DATA_ARRAY_POOL_MAX_HEADERS 64
+// buffers kept per capacity class (power of two bytes) and thread
+#define DATA_ARRAY_POOL_MAX_BUFFERS 4
+// largest pooled buffer class (2^24 bytes = 16 MiB); larger buffers are always allocated and freed directly
+#define DATA_ARRAY_POOL_MAX_CLASS 24
+#define DATA_ARRAY_POOL_NUM_TYPES 3
+// alignment of headers and heap buffers (cache line, enough for any SIMD load)
+#define DATA_ARRAY_BUFFER_ALIGNMENT 64
+#define DATA_ARRAY_HUGE_PAGE_SIZE ((size_t) 2 << 20)
+#define DATA_ARRAY_DEFAULT_HUGE_PAGE_THRESHOLD ((size_t) 32 << 20)
+
+typedef struct PooledHeader {
+	struct PooledHeader *next;
+} PooledHeader;
+
+typedef struct PooledBuffer {
+	void *data;
+	size_t num_bytes;
+} PooledBuffer;
+
+// bookkeeping in front of every heap buffer (padded to the alignment, so the data stays aligned)
+typedef struct BufferPrefix {
+	size_t total_bytes;
+	bool mapped;
+} BufferPrefix;
+
+typedef struct DataArrayPool {
+	PooledHeader *headers[DATA_ARRAY_POOL_NUM_TYPES];
+	int num_headers[DATA_ARRAY_POOL_NUM_TYPES];
+	PooledBuffer buffers[DATA_ARRAY_POOL_MAX_CLASS+1][DATA_ARRAY_POOL_MAX_BUFFERS];
+	int num_buffers[DATA_ARRAY_POOL_MAX_CLASS+1];
+	DataArrayPoolStats stats;
+	bool registered;
+} DataArrayPool;
+
+static atomic_bool pool_enabled = false;
+static atomic_size_t huge_page_threshold = DATA_ARRAY_DEFAULT_HUGE_PAGE_THRESHOLD;
+static _Thread_local DataArrayPool thread_pool;
+static pthread_key_t pool_exit_key;
+static pthread_once_t pool_exit_key_once = PTHREAD_ONCE_INIT;
+
+
+/*
+ * ------------------------------------
+ * Thread Lifetime
+ * ------------------------------------
+ */
+
+static void release_thread_pool(void *unused) {
+	(void) unused;
+	data_array_pool_trim();
+}
+
+static void create_pool_exit_key() {
+	pthread_key_create(&pool_exit_key, release_thread_pool);
+}
+
+// releases the cached objects of a thread when it exits
+static void register_thread_pool() {
+	if(thread_pool.registered) return;
+	pthread_once(&pool_exit_key_once, create_pool_exit_key);
+	pthread_setspecific(pool_exit_key, &thread_pool);
+	thread_pool.registered = true;
+}
+
+
+/*
+ * ------------------------------------
+ * Aligned Storage
+ * ------------------------------------
+ */
+
+static size_t round_up(size_t x, size_t multiple) {
+	return (x + multiple - 1) / multiple * multiple;
+}
+
+// anonymous mapping aligned to huge pages (NULL if mmap fails or is unavailable)
+static void * map_huge_page_block(size_t total_bytes) {
+#ifdef _WIN32
+	(void) total_bytes;
+	return NULL;
+#else
+	char *block = mmap(NULL, total_bytes + DATA_ARRAY_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(block == MAP_FAILED) return NULL;
+	// unmaps the unaligned head and the remaining tail of the over-sized mapping
+	size_t head = round_up((uintptr_t) block, DATA_ARRAY_HUGE_PAGE_SIZE) - (uintptr_t) block;
+	if(head > 0) munmap(block, head);
+	if(head < DATA_ARRAY_HUGE_PAGE_SIZE) munmap(block + head + total_bytes, DATA_ARRAY_HUGE_PAGE_SIZE - head);
+	block += head;
+#ifdef MADV_HUGEPAGE
+	madvise(block, total_bytes, MADV_HUGEPAGE);
+#endif
+	return block;
+#endif
+}
+
+// 64-byte aligned buffer of at least num_bytes; large buffers are backed by transparent huge pages
+static void * alloc_aligned_buffer(size_t num_bytes, size_t *capacity_bytes) {
+	size_t total_bytes = round_up(DATA_ARRAY_BUFFER_ALIGNMENT + num_bytes, DATA_ARRAY_BUFFER_ALIGNMENT);
+	size_t threshold = atomic_load_explicit(&huge_page_threshold, memory_order_relaxed);
+	char *block = NULL;
+	bool mapped = false;
+	if(threshold > 0 && num_bytes >= threshold) {
+		total_bytes = round_up(total_bytes, DATA_ARRAY_HUGE_PAGE_SIZE);
+		block = map_huge_page_block(total_bytes);
+		mapped = block != NULL;
+	}
+	if(!mapped) {
+		total_bytes = round_up(DATA_ARRAY_BUFFER_ALIGNMENT + num_bytes, DATA_ARRAY_BUFFER_ALIGNMENT);
+		block = aligned_alloc(DATA_ARRAY_BUFFER_ALIGNMENT, total_bytes);
+		if(!block) return NULL;
+	}
+	BufferPrefix *prefix = (BufferPrefix *) block;
+	prefix->total_bytes = total_bytes;
+	prefix->mapped = mapped;
+	// the padding of the allocation is usable capacity
+	*capacity_bytes = total_bytes - DATA_ARRAY_BUFFER_ALIGNMENT;
+	return block + DATA_ARRAY_BUFFER_ALIGNMENT;
+}
+
+static void free_aligned_buffer(void *buffer) {
+	if(!buffer) return;
+	BufferPrefix *prefix = (BufferPrefix *) ((char *) buffer - DATA_ARRAY_BUFFER_ALIGNMENT);
+#ifndef _WIN32
+	if(prefix->mapped) {
+		munmap(prefix, prefix->total_bytes);
+		return;
+	}
+#endif
+	free(prefix);
+}
+
+
+/*
+ * ------------------------------------
+ * Headers
+ * ------------------------------------
+ */
+
+// headers are aligned, so are their stack buffers (all header sizes are multiples of the alignment)
+static void * alloc_aligned_header(size_t size) {
+	return aligned_alloc(DATA_ARRAY_BUFFER_ALIGNMENT, round_up(size, DATA_ARRAY_BUFFER_ALIGNMENT));
+}
+
+void * data_array_pool_alloc_header(DataArrayType type, size_t size) {
+	if(!atomic_load_explicit(&pool_enabled, memory_order_relaxed)) return alloc_aligned_header(size);
+
+	int type_idx = type - DATA_ARRAY_TYPE_1;
+	PooledHeader *header = thread_pool.headers[type_idx];
+	if(!header) {
+		thread_pool.stats.header_misses++;
+		return alloc_aligned_header(size);
+	}
+	thread_pool.headers[type_idx] = header->next;
+	thread_pool.num_headers[type_idx]--;
+	thread_pool.stats.header_hits++;
+	return header;
+}
+
+void data_array_pool_free_header(DataArrayType type, void *header) {
+	int type_idx = type - DATA_ARRAY_TYPE_1;
+	if(!atomic_load_explicit(&pool_enabled, memory_order_relaxed) || thread_pool.num_headers[type_idx] == DATA_ARRAY_POOL_MAX_HEADERS) {
+		free(header);
+		return;
+	}
+	register_thread_pool();
+	PooledHeader *pooled = header;
+	pooled->next = thread_pool.headers[type_idx];
+	thread_pool.headers[type_idx] = pooled;
+	thread_pool.num_headers[type_idx]++;
+}
+
+
+/*
+ * ------------------------------------
+ * Buffers
+ * ------------------------------------
+ */
+
+static int floor_log2(size_t x) {
+	int n = -1;
+	while(x) {
+		x >>= 1;
+		n++;
+	}
+	return n;
+}
+
+void * data_array_pool_alloc_buffer(size_t num_bytes, size_t *capacity_bytes) {
+	int buffer_class = floor_log2(num_bytes - 1) + 1;
+	if(!atomic_load_explicit(&pool_enabled, memory_order_relaxed) || buffer_class > DATA_ARRAY_POOL_MAX_CLASS) {
+		return alloc_aligned_buffer(num_bytes, capacity_bytes);
+	}
+
+	// every buffer of a class has at least 2^class bytes
+	if(thread_pool.num_buffers[buffer_class] > 0) {
+		PooledBuffer buffer = thread_pool.buffers[buffer_class][--thread_pool.num_buffers[buffer_class]];
+		thread_pool.stats.buffer_hits++;
+		*capacity_bytes = buffer.num_bytes;
+		return buffer.data;
+	}
+	// rounded up so the buffer can serve every request of its class later
+	thread_pool.stats.buffer_misses++;
+	return alloc_aligned_buffer((size_t) 1 << buffer_class, capacity_bytes);
+}
+
+void data_array_pool_free_buffer(void *buffer, size_t capacity_bytes) {
+	int buffer_class = floor_log2(capacity_bytes);
+	if(!atomic_load_explicit(&pool_enabled, memory_order_relaxed) || buffer_class > DATA_ARRAY_POOL_MAX_CLASS ||
+	   thread_pool.num_buffers[buffer_class] == DATA_ARRAY_POOL_MAX_BUFFERS) {
+		free_aligned_buffer(buffer);
+		return;
+	}
+	register_thread_pool();
+	thread_pool.buffers[buffer_class][thread_pool.num_buffers[buffer_class]++] = (PooledBuffer) {buffer, capacity_bytes};
+}
+
+
+/*
+ * ------------------------------------
+ * Settings and Statistics
+ * ------------------------------------
+ */
+
+void data_array_pool_set_enabled(bool enabled) {
+	atomic_store(&pool_enabled, enabled);
+}
+
+void data_array_set_huge_page_threshold(size_t num_bytes) {
+	atomic_store(&huge_page_threshold, num_bytes);
+}
+
+size_t data_array_get_huge_page_threshold() {
+	return atomic_load(&huge_page_threshold);
+}
+
+DataArrayPoolStats data_array_pool_get_stats() {
+	DataArrayPoolStats stats = thread_pool.stats;
+	for(int t = 0; t < DATA_ARRAY_POOL_NUM_TYPES; t++) stats.cached_headers += thread_pool.num_headers[t];
+	for(int c = 0; c <= DATA_ARRAY_POOL_MAX_CLASS; c++) {
+		for(int i = 0; i < thread_pool.num_buffers[c]; i++) stats.cached_bytes += thread_pool.buffers[c][i].num_bytes;
+	}
+	return stats;
+}
+
+void data_array_pool_reset_stats() {
+	thread_pool.stats = (DataArrayPoolStats) {0};
+}
+
+void data_array_pool_trim() {
+	for(int t = 0; t < DATA_ARRAY_POOL_NUM_TYPES; t++) {
+		while(thread_pool.headers[t]) {
+			PooledHeader *next = thread_pool.headers[t]->next;
+			free(thread_pool.headers[t]);
+			thread_pool.headers[t] = next;
+		}
+		thread_pool.num_headers[t] = 0;
+	}
+	for(int c = 0; c <= DATA_ARRAY_POOL_MAX_CLASS; c++) {
+		for(int i = 0; i < thread_pool.num_buffers[c]; i++) free_aligned_buffer(thread_pool.buffers[c][i].data);
+		thread_pool.num_buffers[c] = 0;
+	}
+}
@@ -0,0 +1,367 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "geometrylib_datastream.h"
+#include "geometrylib_linetool.h"
+#include "data_array_def.h"
+
+#define DATA_ARRAY_STREAM_DEFAULT_CHUNK_SIZE 65536
+
+struct DataArrayStream {
+	FILE *file;
+	DataArrayFileInfo info;
+	size_t chunk_size;
+	size_t position;
+	// chunk buffer of the array type of the file (the others are NULL)
+	DataArray1 *chunk1;
+	DataArray2 *chunk2;
+	DataArray3 *chunk3;
+};
+
+struct DataArrayStreamWriter {
+	FILE *file;
+	DataArrayType type;
+	size_t count;
+	bool sorted;
+	double last[3];
+	bool success;
+};
+
+
+/*
+ * ------------------------------------
+ * Reading
+ * ------------------------------------
+ */
+
+DataArrayStream * data_array_stream_open(const char *path, size_t chunk_size) {
+	DataArrayFileInfo info;
+	if(!data_array_file_get_info(path, &info) || info.type == DATA_ARRAY_TYPE_N || info.dimensions != (int) info.type) return NULL;
+
+	FILE *file = fopen(path, "rb");
+	if(!file) return NULL;
+
+	DataArrayStream *stream = malloc(sizeof(DataArrayStream));
+	stream->file = file;
+	stream->info = info;
+	stream->chunk_size = chunk_size > 0 ? chunk_size : DATA_ARRAY_STREAM_DEFAULT_CHUNK_SIZE;
+	stream->chunk1 = NULL;
+	stream->chunk2 = NULL;
+	stream->chunk3 = NULL;
+	switch(info.type) {
+		case DATA_ARRAY_TYPE_1:
+			stream->chunk1 = data_array1_create();
+			data_array1_reserve(stream->chunk1, stream->chunk_size);
+			break;
+		case DATA_ARRAY_TYPE_2:
+			stream->chunk2 = data_array2_create();
+			data_array2_reserve(stream->chunk2, stream->chunk_size);
+			break;
+		default:
+			stream->chunk3 = data_array3_create();
+			data_array3_reserve(stream->chunk3, stream->chunk_size);
+			break;
+	}
+	data_array_stream_rewind(stream);
+	return stream;
+}
+
+void data_array_stream_close(DataArrayStream *stream) {
+	if(!stream) return;
+	fclose(stream->file);
+	data_array1_free(stream->chunk1);
+	data_array2_free(stream->chunk2);
+	data_array3_free(stream->chunk3);
+	free(stream);
+}
+
+DataArrayFileInfo data_array_stream_get_info(DataArrayStream *stream) {
+	return stream->info;
+}
+
+void data_array_stream_rewind(DataArrayStream *stream) {
+	stream->position = fseek(stream->file, (long) stream->info.data_offset, SEEK_SET) == 0 ? 0 : stream->info.count;
+}
+
+// reads up to chunk_size elements into dst; returns the number of elements read (0 at the end or on errors)
+static size_t read_stream_chunk(DataArrayStream *stream, void *dst) {
+	size_t num_elem = stream->info.count - stream->position;
+	if(num_elem > stream->chunk_size) num_elem = stream->chunk_size;
+	if(num_elem == 0) return 0;
+
+	// the chunk buffers are reserved by type, so the element size must not come from the header's dimensions
+	size_t elem_size = (size_t) stream->info.type * sizeof(double);
+	if(fread(dst, elem_size, num_elem, stream->file) != num_elem) {
+		stream->position = stream->info.count;
+		return 0;
+	}
+	stream->position += num_elem;
+	return num_elem;
+}
+
+DataArray1 * data_array1_stream_next(DataArrayStream *stream) {
+	if(!stream || !stream->chunk1) return NULL;
+	stream->chunk1->count = read_stream_chunk(stream, stream->chunk1->data);
+	data_array1_invalidate_cache(stream->chunk1);
+	return stream->chunk1->count > 0 ? stream->chunk1 : NULL;
+}
+
+DataArray2 * data_array2_stream_next(DataArrayStream *stream) {
+	if(!stream || !stream->chunk2) return NULL;
+	stream->chunk2->count = read_stream_chunk(stream, stream->chunk2->data);
+	data_array2_invalidate_cache(stream->chunk2);
+	return stream->chunk2->count > 0 ? stream->chunk2 : NULL;
+}
+
+DataArray3 * data_array3_stream_next(DataArrayStream *stream) {
+	if(!stream || !stream->chunk3) return NULL;
+	stream->chunk3->count = read_stream_chunk(stream, stream->chunk3->data);
+	data_array3_invalidate_cache(stream->chunk3);
+	return stream->chunk3->count > 0 ? stream->chunk3 : NULL;
+}
+
+
+/*
+ * ------------------------------------
+ * Writing
+ * ------------------------------------
+ */
+
+DataArrayStreamWriter * data_array_stream_writer_create(const char *path, DataArrayType type) {
+	if(type < DATA_ARRAY_TYPE_1 || type > DATA_ARRAY_TYPE_3) return NULL;
+	FILE *file = fopen(path, "wb");
+	if(!file) return NULL;
+
+	DataArrayStreamWriter *writer = malloc(sizeof(DataArrayStreamWriter));
+	writer->file = file;
+	writer->type = type;
+	writer->count = 0;
+	writer->sorted = true;
+	writer->success = write_data_array_file_header(file, type, (int) type, 0, true);
+	return writer;
+}
+
+// elements are sorted if each is lexicographically not smaller than the one before it
+static bool is_row_in_order(const double *prev, const double *row, int num_comp) {
+	for(int c = 0; c < num_comp; c++) {
+		if(row[c] > prev[c]) return true;
+		if(row[c] < prev[c]) return false;
+	}
+	return true;
+}
+
+static bool append_stream_chunk(DataArrayStreamWriter *writer, DataArrayType type, const double *data, size_t count) {
+	if(!writer || writer->type != type) return false;
+	if(count == 0) return writer->success;
+
+	int num_comp = (int) type;
+	if(writer->sorted && writer->count > 0) writer->sorted = is_row_in_order(writer->last, data, num_comp);
+	for(size_t i = 1; writer->sorted && i < count; i++) {
+		writer->sorted = is_row_in_order(data + (i-1)*num_comp, data + i*num_comp, num_comp);
+	}
+	memcpy(writer->last, data + (count-1)*num_comp, num_comp * sizeof(double));
+
+	if(writer->success) writer->success = fwrite(data, num_comp * sizeof(double), count, writer->file) == count;
+	writer->count += count;
+	return writer->success;
+}
+
+bool data_array1_stream_writer_append(DataArrayStreamWriter *writer, DataArray1 *chunk) {
+	if(!chunk) return false;
+	return append_stream_chunk(writer, DATA_ARRAY_TYPE_1, chunk->data, chunk->count);
+}
+
+bool data_array2_stream_writer_append(DataArrayStreamWriter *writer, DataArray2 *chunk) {
+	if(!chunk) return false;
+	return append_stream_chunk(writer, DATA_ARRAY_TYPE_2, (const double *) chunk->data, chunk->count);
+}
+
+bool data_array3_stream_writer_append(DataArrayStreamWriter *writer, DataArray3 *chunk) {
+	if(!chunk) return false;
+	return append_stream_chunk(writer, DATA_ARRAY_TYPE_3, (const double *) chunk->data, chunk->count);
+}
+
+bool data_array_stream_writer_close(DataArrayStreamWriter *writer) {
+	if(!writer) return false;
+	bool success = writer->success;
+	if(success) success = fseek(writer->file, 0, SEEK_SET) == 0;
+	if(success) success = write_data_array_file_header(writer->file, writer->type, (int) writer->type, writer->count, writer->sorted);
+	if(fclose(writer->file) != 0) success = false;
+	free(writer);
+	return success;
+}
+
+
+/*
+ * ------------------------------------
+ * Chunk Functions
+ * ------------------------------------
+ */
+
+void data_array1_get_diff_chunk(DataArray1 *chunk, DataChunkState *state, DataArray1 *diff) {
+	if(!chunk || !state || !diff) return;
+	for(size_t i = 0; i < chunk->count; i++) {
+		if(state->has_last) data_array1_append_new(diff, chunk->data[i] - state->last.x);
+		state->last.x = chunk->data[i];
+		state->has_last = true;
+	}
+}
+
+void data_array2_get_gradient_chunk(DataArray2 *chunk, DataChunkState *state, DataArray2 *gradient) {
+	if(!chunk || !state || !gradient) return;
+	for(size_t i = 0; i < chunk->count; i++) {
+		Vector2 p0 = state->last, p1 = chunk->data[i];
+		if(state->has_last) data_array2_append_new(gradient, vec2((p0.x+p1.x)/2, (p1.y-p0.y)/(p1.x-p0.x)));
+		state->last = p1;
+		state->has_last = true;
+	}
+}
+
+
+/*
+ * ------------------------------------
+ * Stream Functions
+ * ------------------------------------
+ */
+
+DataBounds1 data_array1_stream_get_minmax(DataArrayStream *stream) {
+	DataBounds1 bounds = {NAN, NAN};
+	if(!stream || !stream->chunk1) return bounds;
+	data_array_stream_rewind(stream);
+
+	bool first = true;
+	DataArray1 *chunk;
+	while((chunk = data_array1_stream_next(stream))) {
+		DataBounds1 chunk_bounds = data_array1_get_minmax(chunk);
+		if(first || chunk_bounds.min < bounds.min) bounds.min = chunk_bounds.min;
+		if(first || chunk_bounds.max > bounds.max) bounds.max = chunk_bounds.max;
+		first = false;
+	}
+	return bounds;
+}
+
+DataBounds2 data_array2_stream_get_bounds(DataArrayStream *stream) {
+	DataBounds2 bounds = {vec2(NAN, NAN), vec2(NAN, NAN)};
+	if(!stream || !stream->chunk2) return bounds;
+	data_array_stream_rewind(stream);
+
+	bool first = true;
+	DataArray2 *chunk;
+	while((chunk = data_array2_stream_next(stream))) {
+		DataBounds2 chunk_bounds = data_array2_get_bounds(chunk);
+		if(first || chunk_bounds.min.x < bounds.min.x) bounds.min.x = chunk_bounds.min.x;
+		if(first || chunk_bounds.min.y < bounds.min.y) bounds.min.y = chunk_bounds.min.y;
+		if(first || chunk_bounds.max.x > bounds.max.x) bounds.max.x = chunk_bounds.max.x;
+		if(first || chunk_bounds.max.y > bounds.max.y) bounds.max.y = chunk_bounds.max.y;
+		first = false;
+	}
+	return bounds;
+}
+
+DataBounds3 data_array3_stream_get_bounds(DataArrayStream *stream) {
+	DataBounds3 bounds = {vec3(NAN, NAN, NAN), vec3(NAN, NAN, NAN)};
+	if(!stream || !stream->chunk3) return bounds;
+	data_array_stream_rewind(stream);
+
+	bool first = true;
+	DataArray3 *chunk;
+	while((chunk = data_array3_stream_next(stream))) {
+		DataBounds3 chunk_bounds = data_array3_get_bounds(chunk);
+		if(first || chunk_bounds.min.x < bounds.min.x) bounds.min.x = chunk_bounds.min.x;
+		if(first || chunk_bounds.min.y < bounds.min.y) bounds.min.y = chunk_bounds.min.y;
+		if(first || chunk_bounds.min.z < bounds.min.z) bounds.min.z = chunk_bounds.min.z;
+		if(first || chunk_bounds.max.x > bounds.max.x) bounds.max.x = chunk_bounds.max.x;
+		if(first || chunk_bounds.max.y > bounds.max.y) bounds.max.y = chunk_bounds.max.y;
+		if(first || chunk_bounds.max.z > bounds.max.z) bounds.max.z = chunk_bounds.max.z;
+		first = false;
+	}
+	return bounds;
+}
+
+bool data_array1_stream_get_diff(DataArrayStream *stream, const char *path) {
+	if(!stream || !stream->chunk1) return false;
+	DataArrayStreamWriter *writer = data_array_stream_writer_create(path, DATA_ARRAY_TYPE_1);
+	if(!writer) return false;
+	data_array_stream_rewind(stream);
+
+	DataChunkState state = {0};
+	DataArray1 *diff = data_array1_create();
+	data_array1_reserve(diff, stream->chunk_size);
+	DataArray1 *chunk;
+	while((chunk = data_array1_stream_next(stream))) {
+		diff->count = 0;
+		data_array1_get_diff_chunk(chunk, &state, diff);
+		data_array1_stream_writer_append(writer, diff);
+	}
+	data_array1_free(diff);
+
+	bool success = stream->position == stream->info.count;
+	return data_array_stream_writer_close(writer) && success;
+}
+
+bool data_array2_stream_get_gradient(DataArrayStream *stream, const char *path) {
+	if(!stream || !stream->chunk2) return false;
+	DataArrayStreamWriter *writer = data_array_stream_writer_create(path, DATA_ARRAY_TYPE_2);
+	if(!writer) return false;
+	data_array_stream_rewind(stream);
+
+	DataChunkState state = {0};
+	DataArray2 *gradient = data_array2_create();
+	data_array2_reserve(gradient, stream->chunk_size);
+	DataArray2 *chunk;
+	while((chunk = data_array2_stream_next(stream))) {
+		gradient->count = 0;
+		data_array2_get_gradient_chunk(chunk, &state, gradient);
+		data_array2_stream_writer_append(writer, gradient);
+	}
+	data_array2_free(gradient);
+
+	bool success = stream->position == stream->info.count;
+	return data_array_stream_writer_close(writer) && success;
+}
+
+// walks the points of a stream across chunk boundaries
+typedef struct StreamPointCursor {
+	DataArrayStream *stream;
+	DataArray2 *chunk;
+	size_t idx;
+} StreamPointCursor;
+
+static bool stream_cursor_next(StreamPointCursor *cursor, Vector2 *point) {
+	while(!cursor->chunk || cursor->idx == cursor->chunk->count) {
+		cursor->chunk = data_array2_stream_next(cursor->stream);
+		cursor->idx = 0;
+		if(!cursor->chunk) return false;
+	}
+	*point = cursor->chunk->data[cursor->idx++];
+	return true;
+}
+
+DataArray2 * get_line_intersections_stream(DataArrayStream *line0, DataArrayStream *line1) {
+	DataArray2 *inters_points = data_array2_create();
+	if(!line0 || !line1 || !line0->chunk2 || !line1->chunk2) return inters_points;
+	data_array_stream_rewind(line0);
+	data_array_stream_rewind(line1);
+
+	StreamPointCursor cursor0 = {.stream = line0}, cursor1 = {.stream = line1};
+	Vector2 u0, u1, v0, v1;
+	if(!stream_cursor_next(&cursor0, &u0) || !stream_cursor_next(&cursor0, &u1)) return inters_points;
+	if(!stream_cursor_next(&cursor1, &v0) || !stream_cursor_next(&cursor1, &v1)) return inters_points;
+
+	// merge sweep over x: the current segment ending first is advanced
+	while(true) {
+		if(u1.x >= v0.x && v1.x >= u0.x && are_line_segments_intersecting2(u0, u1, v0, v1)) {
+			data_array2_append_new(inters_points, get_line_segment_intersection(u0, u1, v0, v1));
+		}
+		if(u1.x <= v1.x) {
+			u0 = u1;
+			if(!stream_cursor_next(&cursor0, &u1)) break;
+		} else {
+			v0 = v1;
+			if(!stream_cursor_next(&cursor1, &v1)) break;
+		}
+	}
+
+	return inters_points;
+}
@@ -2,6 +2,9 @@
 
 #include "geometrylib_datatool.h"
 #include "data_array_def.h"
+#include "instrument.h"
+#include "parallel.h"
+#include "simd.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -17,30 +20,133 @@ Vector2 * data_array2_get_data(DataArray2 *arr) {return arr->data;}
 Vector3 * data_array3_get_data(DataArray3 *arr) {return arr->data;}
 double ** data_arrayn_get_data(DataArrayN *arr) {return arr->data;}
 
+static void data_array1_free_storage(DataArray1 *arr) {
+	if(arr->using_heap) {
+		data_array_pool_free_buffer(arr->data, arr->capacity * sizeof(double));
+		INSTRUMENT(instrument_buffer_freed(arr->capacity * sizeof(double)));
+	}
+	if(arr->mapping) release_data_array_mapping(arr->mapping, arr->mapping_size);
+	arr->mapping = NULL;
+	arr->mapping_size = 0;
+}
+
+static void data_array2_free_storage(DataArray2 *arr) {
+	if(arr->using_heap) {
+		data_array_pool_free_buffer(arr->data, arr->capacity * sizeof(Vector2));
+		INSTRUMENT(instrument_buffer_freed(arr->capacity * sizeof(Vector2)));
+	}
+	if(arr->mapping) release_data_array_mapping(arr->mapping, arr->mapping_size);
+	arr->mapping = NULL;
+	arr->mapping_size = 0;
+}
+
+static void data_array3_free_storage(DataArray3 *arr) {
+	if(arr->using_heap) {
+		data_array_pool_free_buffer(arr->data, arr->capacity * sizeof(Vector3));
+		INSTRUMENT(instrument_buffer_freed(arr->capacity * sizeof(Vector3)));
+	}
+	if(arr->mapping) release_data_array_mapping(arr->mapping, arr->mapping_size);
+	arr->mapping = NULL;
+	arr->mapping_size = 0;
+}
+
+// moves data of a read-only file mapping into own memory before modifying it in place
+void data_array1_make_writable(DataArray1 *arr) {
+	if(!arr->mapping) return;
+	size_t capacity = DATA_ARRAY_STACK_LIMIT;
+	double *new_data = arr->stack_buffer;
+	if(arr->count > DATA_ARRAY_STACK_LIMIT) {
+		size_t num_bytes;
+		new_data = data_array_pool_alloc_buffer(arr->count * sizeof(double), &num_bytes);
+		capacity = num_bytes / sizeof(double);
+		INSTRUMENT(instrument_buffer_allocated(num_bytes / sizeof(double) * sizeof(double)));
+	}
+	INSTRUMENT(instrument_growth(arr->count * sizeof(double), false));
+	memcpy(new_data, arr->data, arr->count * sizeof(double));
+	data_array1_free_storage(arr);
+	arr->data = new_data;
+	arr->capacity = capacity;
+	arr->using_heap = new_data != arr->stack_buffer;
+}
+
+// moves data of a read-only file mapping into own memory before modifying it in place
+void data_array2_make_writable(DataArray2 *arr) {
+	if(!arr->mapping) return;
+	size_t capacity = DATA_ARRAY_STACK_LIMIT;
+	Vector2 *new_data = arr->stack_buffer;
+	if(arr->count > DATA_ARRAY_STACK_LIMIT) {
+		size_t num_bytes;
+		new_data = data_array_pool_alloc_buffer(arr->count * sizeof(Vector2), &num_bytes);
+		capacity = num_bytes / sizeof(Vector2);
+		INSTRUMENT(instrument_buffer_allocated(num_bytes / sizeof(Vector2) * sizeof(Vector2)));
+	}
+	INSTRUMENT(instrument_growth(arr->count * sizeof(Vector2), false));
+	memcpy(new_data, arr->data, arr->count * sizeof(Vector2));
+	data_array2_free_storage(arr);
+	arr->data = new_data;
+	arr->capacity = capacity;
+	arr->using_heap = new_data != arr->stack_buffer;
+}
+
+// moves data of a read-only file mapping into own memory before modifying it in place
+void data_array3_make_writable(DataArray3 *arr) {
+	if(!arr->mapping) return;
+	size_t capacity = DATA_ARRAY_STACK_LIMIT;
+	Vector3 *new_data = arr->stack_buffer;
+	if(arr->count > DATA_ARRAY_STACK_LIMIT) {
+		size_t num_bytes;
+		new_data = data_array_pool_alloc_buffer(arr->count * sizeof(Vector3), &num_bytes);
+		capacity = num_bytes / sizeof(Vector3);
+		INSTRUMENT(instrument_buffer_allocated(num_bytes / sizeof(Vector3) * sizeof(Vector3)));
+	}
+	INSTRUMENT(instrument_growth(arr->count * sizeof(Vector3), false));
+	memcpy(new_data, arr->data, arr->count * sizeof(Vector3));
+	data_array3_free_storage(arr);
+	arr->data = new_data;
+	arr->capacity = capacity;
+	arr->using_heap = new_data != arr->stack_buffer;
+}
+
 DataArray1 * data_array1_create() {
-	DataArray1* arr = malloc(sizeof(DataArray1));
+	DataArray1* arr = data_array_pool_alloc_header(DATA_ARRAY_TYPE_1, sizeof(DataArray1));
+	INSTRUMENT(instrument_array_created(DATA_ARRAY_TYPE_1, sizeof(DataArray1)));
 	arr->data = arr->stack_buffer;
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	arr->using_heap = false;
+	arr->mapping = NULL;
+	arr->mapping_size = 0;
+	arr->aggregates.enabled = false;
+	arr->aggregates.valid = false;
 	return arr;
 }
 
 DataArray2 * data_array2_create() {
-	DataArray2* arr = malloc(sizeof(DataArray2));
+	DataArray2* arr = data_array_pool_alloc_header(DATA_ARRAY_TYPE_2, sizeof(DataArray2));
+	INSTRUMENT(instrument_array_created(DATA_ARRAY_TYPE_2, sizeof(DataArray2)));
 	arr->data = arr->stack_buffer;
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	arr->using_heap = false;
+	arr->mapping = NULL;
+	arr->mapping_size = 0;
+	arr->aggregates.enabled = false;
+	arr->aggregates.valid = false;
+	arr->spacing.valid = false;
 	return arr;
 }
 
 DataArray3 * data_array3_create() {
-	DataArray3* arr = malloc(sizeof(DataArray3));
+	DataArray3* arr = data_array_pool_alloc_header(DATA_ARRAY_TYPE_3, sizeof(DataArray3));
+	INSTRUMENT(instrument_array_created(DATA_ARRAY_TYPE_3, sizeof(DataArray3)));
 	arr->data = arr->stack_buffer;
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	arr->using_heap = false;
+	arr->mapping = NULL;
+	arr->mapping_size = 0;
+	arr->aggregates.enabled = false;
+	arr->aggregates.valid = false;
 	return arr;
 }
 
@@ -51,66 +157,79 @@ DataArrayN * data_arrayn_create(int dimensions) {
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	for(int i = 0; i < arr->capacity; i++) arr->data[i] = malloc(dimensions*sizeof(double));
+	INSTRUMENT(instrument_array_created(DATA_ARRAY_TYPE_N, sizeof(DataArrayN)));
+	INSTRUMENT(instrument_bytes_allocated(arr->capacity * (sizeof(double *) + dimensions*sizeof(double))));
 	return arr;
 }
 
 void data_array1_clear(DataArray1 *arr) {
 	if(!arr) return;
-	if(arr->using_heap) free(arr->data);
+	data_array1_free_storage(arr);
 	arr->data = arr->stack_buffer;
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	arr->using_heap = false;
+	arr->aggregates.valid = false;
 }
 
 void data_array2_clear(DataArray2 *arr) {
 	if(!arr) return;
-	if(arr->using_heap) free(arr->data);
+	data_array2_free_storage(arr);
 	arr->data = arr->stack_buffer;
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	arr->using_heap = false;
+	arr->aggregates.valid = false;
+	arr->spacing.valid = false;
 }
 
 void data_array3_clear(DataArray3 *arr) {
 	if(!arr) return;
-	if(arr->using_heap) free(arr->data);
+	data_array3_free_storage(arr);
 	arr->data = arr->stack_buffer;
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	arr->using_heap = false;
+	arr->aggregates.valid = false;
 }
 
 void data_arrayn_clear(DataArrayN *arr) {
 	if(!arr) return;
+	INSTRUMENT(instrument_bytes_freed(arr->capacity * (sizeof(double *) + arr->dimensions*sizeof(double))));
 	for(int i = 0; i < arr->capacity; i++) free(arr->data[i]);
 	free(arr->data);
 	arr->data = malloc(DATA_ARRAY_STACK_LIMIT*sizeof(double*));
 	arr->count = 0;
 	arr->capacity = DATA_ARRAY_STACK_LIMIT;
 	for(int i = 0; i < arr->capacity; i++) arr->data[i] = malloc(arr->dimensions*sizeof(double));
+	INSTRUMENT(instrument_bytes_allocated(arr->capacity * (sizeof(double *) + arr->dimensions*sizeof(double))));
 }
 
 void data_array1_free(DataArray1* arr) {
 	if(!arr) return;
-	if(arr->using_heap) free(arr->data);
-	free(arr);
+	data_array1_free_storage(arr);
+	INSTRUMENT(instrument_array_freed(DATA_ARRAY_TYPE_1, sizeof(DataArray1)));
+	data_array_pool_free_header(DATA_ARRAY_TYPE_1, arr);
 }
 
 void data_array2_free(DataArray2* arr) {
 	if(!arr) return;
-	if(arr->using_heap) free(arr->data);
-	free(arr);
+	data_array2_free_storage(arr);
+	INSTRUMENT(instrument_array_freed(DATA_ARRAY_TYPE_2, sizeof(DataArray2)));
+	data_array_pool_free_header(DATA_ARRAY_TYPE_2, arr);
 }
 
 void data_array3_free(DataArray3* arr) {
 	if(!arr) return;
-	if(arr->using_heap) free(arr->data);
-	free(arr);
+	data_array3_free_storage(arr);
+	INSTRUMENT(instrument_array_freed(DATA_ARRAY_TYPE_3, sizeof(DataArray3)));
+	data_array_pool_free_header(DATA_ARRAY_TYPE_3, arr);
 }
 
 void data_arrayn_free(DataArrayN* arr) {
 	if(!arr) return;
+	INSTRUMENT(instrument_array_freed(DATA_ARRAY_TYPE_N, sizeof(DataArrayN)));
+	INSTRUMENT(instrument_bytes_freed(arr->capacity * (sizeof(double *) + arr->dimensions*sizeof(double))));
 	for(int i = 0; i < arr->capacity; i++) free(arr->data[i]);
 	free(arr->data);
 	free(arr);
@@ -148,11 +267,7 @@ DataArray1 *data_array1_slice(DataArray1 *arr, int start, int end) {
 	DataArray1 *slice = data_array1_create();
 	int num_elem = end-start+1;
 
-	if(num_elem > DATA_ARRAY_STACK_LIMIT) {
-		slice->capacity = num_elem;
-		slice->data = malloc(num_elem * sizeof(double));
-		slice->using_heap = true;
-	}
+	data_array1_reserve(slice, num_elem);
 	memcpy(slice->data, arr->data+start, num_elem*sizeof(double));
 	slice->count = num_elem;
 
@@ -167,11 +282,7 @@ DataArray2 *data_array2_slice(DataArray2 *arr, int start, int end) {
 	DataArray2 *slice = data_array2_create();
 	int num_elem = end-start+1;
 
-	if(num_elem > DATA_ARRAY_STACK_LIMIT) {
-		slice->capacity = num_elem;
-		slice->data = malloc(num_elem * sizeof(Vector2));
-		slice->using_heap = true;
-	}
+	data_array2_reserve(slice, num_elem);
 	memcpy(slice->data, arr->data+start, num_elem*sizeof(Vector2));
 	slice->count = num_elem;
 
@@ -186,78 +297,184 @@ DataArray3 *data_array3_slice(DataArray3 *arr, int start, int end) {
 	DataArray3 *slice = data_array3_create();
 	int num_elem = end-start+1;
 
-	if(num_elem > DATA_ARRAY_STACK_LIMIT) {
-		slice->capacity = num_elem;
-		slice->data = malloc(num_elem * sizeof(Vector3));
-		slice->using_heap = true;
-	}
+	data_array3_reserve(slice, num_elem);
 	memcpy(slice->data, arr->data+start, num_elem*sizeof(Vector3));
 	slice->count = num_elem;
 
 	return slice;
 }
 
-void check_data_array1_add_capacity(DataArray1 *arr) {
-	if(arr->count >= arr->capacity) {
-		size_t new_capacity = arr->capacity * 2;
-		double *new_data = malloc(new_capacity * sizeof(double));
-		memcpy(new_data, arr->data, arr->count * sizeof(double));
-		if(arr->using_heap) free(arr->data);
-		arr->data = new_data;
-		arr->capacity = new_capacity;
-		arr->using_heap = true;
+static void data_array1_aggregates_add(DataArray1 *arr, double value) {
+	DataAggregates1 *agg = &arr->aggregates;
+	if(!agg->enabled) return;
+	if(arr->count == 1) {
+		agg->bounds = (DataBounds1) {value, value};
+		agg->sum = value;
+		agg->valid = true;
+		return;
 	}
+	if(!agg->valid) return;
+	// NaN handling depends on the position of the NaN -> leave it to the full scan
+	if(isnan(value)) { agg->valid = false; return; }
+	if(agg->bounds.min > value) agg->bounds.min = value;
+	if(agg->bounds.max < value) agg->bounds.max = value;
+	agg->sum += value;
 }
 
-void check_data_array2_add_capacity(DataArray2 *arr) {
-	if(arr->count >= arr->capacity) {
-		size_t new_capacity = arr->capacity * 2;
-		Vector2 *new_data = malloc(new_capacity * sizeof(Vector2));
-		memcpy(new_data, arr->data, arr->count * sizeof(Vector2));
-		if(arr->using_heap) free(arr->data);
-		arr->data = new_data;
-		arr->capacity = new_capacity;
-		arr->using_heap = true;
+static void data_array2_aggregates_add(DataArray2 *arr, Vector2 value) {
+	DataAggregates2 *agg = &arr->aggregates;
+	if(!agg->enabled) return;
+	if(arr->count == 1) {
+		agg->bounds = (DataBounds2) {value, value};
+		agg->sum = value;
+		agg->valid = true;
+		return;
 	}
+	if(!agg->valid) return;
+	if(isnan(value.x) || isnan(value.y)) { agg->valid = false; return; }
+	if(agg->bounds.min.x > value.x) agg->bounds.min.x = value.x;
+	if(agg->bounds.min.y > value.y) agg->bounds.min.y = value.y;
+	if(agg->bounds.max.x < value.x) agg->bounds.max.x = value.x;
+	if(agg->bounds.max.y < value.y) agg->bounds.max.y = value.y;
+	agg->sum = add_vec2(agg->sum, value);
 }
 
-void check_data_array3_add_capacity(DataArray3 *arr) {
-	if(arr->count >= arr->capacity) {
-		size_t new_capacity = arr->capacity * 2;
-		Vector3 *new_data = malloc(new_capacity * sizeof(Vector3));
-		memcpy(new_data, arr->data, arr->count * sizeof(Vector3));
-		if(arr->using_heap) free(arr->data);
-		arr->data = new_data;
-		arr->capacity = new_capacity;
-		arr->using_heap = true;
+static void data_array3_aggregates_add(DataArray3 *arr, Vector3 value) {
+	DataAggregates3 *agg = &arr->aggregates;
+	if(!agg->enabled) return;
+	if(arr->count == 1) {
+		agg->bounds = (DataBounds3) {value, value};
+		agg->sum = value;
+		agg->valid = true;
+		return;
 	}
+	if(!agg->valid) return;
+	if(isnan(value.x) || isnan(value.y) || isnan(value.z)) { agg->valid = false; return; }
+	if(agg->bounds.min.x > value.x) agg->bounds.min.x = value.x;
+	if(agg->bounds.min.y > value.y) agg->bounds.min.y = value.y;
+	if(agg->bounds.min.z > value.z) agg->bounds.min.z = value.z;
+	if(agg->bounds.max.x < value.x) agg->bounds.max.x = value.x;
+	if(agg->bounds.max.y < value.y) agg->bounds.max.y = value.y;
+	if(agg->bounds.max.z < value.z) agg->bounds.max.z = value.z;
+	agg->sum = add_vec3(agg->sum, value);
+}
+
+// called before removing; bounds only stay valid if the removed value lies strictly inside of them
+static void data_array1_aggregates_remove(DataArray1 *arr, int idx) {
+	DataAggregates1 *agg = &arr->aggregates;
+	if(!agg->valid) return;
+	double value = arr->data[idx];
+	if(idx > 0 && value > agg->bounds.min && value < agg->bounds.max) agg->sum -= value;
+	else agg->valid = false;
+}
+
+static void data_array2_aggregates_remove(DataArray2 *arr, int idx) {
+	DataAggregates2 *agg = &arr->aggregates;
+	if(!agg->valid) return;
+	Vector2 value = arr->data[idx];
+	if(idx > 0 &&
+	   value.x > agg->bounds.min.x && value.x < agg->bounds.max.x &&
+	   value.y > agg->bounds.min.y && value.y < agg->bounds.max.y) agg->sum = subtract_vec2(agg->sum, value);
+	else agg->valid = false;
+}
+
+static void data_array3_aggregates_remove(DataArray3 *arr, int idx) {
+	DataAggregates3 *agg = &arr->aggregates;
+	if(!agg->valid) return;
+	Vector3 value = arr->data[idx];
+	if(idx > 0 &&
+	   value.x > agg->bounds.min.x && value.x < agg->bounds.max.x &&
+	   value.y > agg->bounds.min.y && value.y < agg->bounds.max.y &&
+	   value.z > agg->bounds.min.z && value.z < agg->bounds.max.z) agg->sum = subtract_vec3(agg->sum, value);
+	else agg->valid = false;
+}
+
+void data_array1_reserve(DataArray1 *arr, size_t capacity) {
+	if(!arr || capacity <= arr->capacity) return;
+	size_t num_bytes;
+	double *new_data = data_array_pool_alloc_buffer(capacity * sizeof(double), &num_bytes);
+	memcpy(new_data, arr->data, arr->count * sizeof(double));
+	INSTRUMENT(instrument_buffer_allocated(num_bytes / sizeof(double) * sizeof(double)));
+	INSTRUMENT(instrument_growth(arr->count * sizeof(double), !arr->using_heap && !arr->mapping));
+	data_array1_free_storage(arr);
+	arr->data = new_data;
+	arr->capacity = num_bytes / sizeof(double);
+	arr->using_heap = true;
+}
+
+void check_data_array1_add_capacity(DataArray1 *arr) {
+	if(arr->count >= arr->capacity) data_array1_reserve(arr, arr->capacity * 2);
+}
+
+void data_array2_reserve(DataArray2 *arr, size_t capacity) {
+	if(!arr || capacity <= arr->capacity) return;
+	size_t num_bytes;
+	Vector2 *new_data = data_array_pool_alloc_buffer(capacity * sizeof(Vector2), &num_bytes);
+	memcpy(new_data, arr->data, arr->count * sizeof(Vector2));
+	INSTRUMENT(instrument_buffer_allocated(num_bytes / sizeof(Vector2) * sizeof(Vector2)));
+	INSTRUMENT(instrument_growth(arr->count * sizeof(Vector2), !arr->using_heap && !arr->mapping));
+	data_array2_free_storage(arr);
+	arr->data = new_data;
+	arr->capacity = num_bytes / sizeof(Vector2);
+	arr->using_heap = true;
+}
+
+void check_data_array2_add_capacity(DataArray2 *arr) {
+	if(arr->count >= arr->capacity) data_array2_reserve(arr, arr->capacity * 2);
+}
+
+void data_array3_reserve(DataArray3 *arr, size_t capacity) {
+	if(!arr || capacity <= arr->capacity) return;
+	size_t num_bytes;
+	Vector3 *new_data = data_array_pool_alloc_buffer(capacity * sizeof(Vector3), &num_bytes);
+	memcpy(new_data, arr->data, arr->count * sizeof(Vector3));
+	INSTRUMENT(instrument_buffer_allocated(num_bytes / sizeof(Vector3) * sizeof(Vector3)));
+	INSTRUMENT(instrument_growth(arr->count * sizeof(Vector3), !arr->using_heap && !arr->mapping));
+	data_array3_free_storage(arr);
+	arr->data = new_data;
+	arr->capacity = num_bytes / sizeof(Vector3);
+	arr->using_heap = true;
+}
+
+void check_data_array3_add_capacity(DataArray3 *arr) {
+	if(arr->count >= arr->capacity) data_array3_reserve(arr, arr->capacity * 2);
+}
+
+void data_arrayn_reserve(DataArrayN *arr, size_t capacity) {
+	if(!arr || capacity <= arr->capacity) return;
+	double **new_data = malloc(capacity * sizeof(double *));
+	memcpy(new_data, arr->data, arr->capacity * sizeof(double *));
+	for(size_t i = arr->capacity; i < capacity; i++) new_data[i] = malloc(arr->dimensions*sizeof(double));
+	// only the row pointers are copied, the rows stay in place
+	INSTRUMENT(instrument_bytes_allocated(capacity * sizeof(double *) + (capacity - arr->capacity) * arr->dimensions*sizeof(double)));
+	INSTRUMENT(instrument_bytes_freed(arr->capacity * sizeof(double *)));
+	INSTRUMENT(instrument_growth(arr->capacity * sizeof(double *), false));
+	free(arr->data);
+	arr->data = new_data;
+	arr->capacity = capacity;
 }
 
 void check_data_arrayn_add_capacity(DataArrayN *arr) {
-	if(arr->count >= arr->capacity) {
-		size_t new_capacity = arr->capacity * 2;
-		double **new_data = malloc(new_capacity * sizeof(double *));
-		memcpy(new_data, arr->data, arr->count * sizeof(double *));
-		for(int i = (int)arr->count; i < new_capacity; i++) new_data[i] = malloc(arr->dimensions*sizeof(double));
-		free(arr->data);
-		arr->data = new_data;
-		arr->capacity = new_capacity;
-	}
+	if(arr->count >= arr->capacity) data_arrayn_reserve(arr, arr->capacity * 2);
 }
 
 void data_array1_append_new(DataArray1 *arr, double value) {
 	check_data_array1_add_capacity(arr);
 	arr->data[arr->count++] = value;
+	data_array1_aggregates_add(arr, value);
 }
 
 void data_array2_append_new(DataArray2 *arr, Vector2 value) {
 	check_data_array2_add_capacity(arr);
 	arr->data[arr->count++] = value;
+	data_array2_aggregates_add(arr, value);
+	arr->spacing.valid = false;
 }
 
 void data_array3_append_new(DataArray3 *arr, Vector3 value) {
 	check_data_array3_add_capacity(arr);
 	arr->data[arr->count++] = value;
+	data_array3_aggregates_add(arr, value);
 }
 
 void data_arrayn_append_new_from_values(DataArrayN *arr, double *values) {
@@ -296,21 +513,7 @@ int data_array2_idx_from_binary_search(DataArray2 *arr, Vector2 value) {
 	if(value.x < arr->data[0].x) return 0;
 	if(value.x > arr->data[arr->count - 1].x) return (int) arr->count;
 
-	int ins_idx = -1;
-	if(value.x == arr->data[0].x) ins_idx = 0;
-
-	int idx0 = 0, idx1 = (int) arr->count - 1;
-
-	while(ins_idx < 0) {
-		// + 1 to ceil and not floor if necessary (first idx already checked, last index not)
-		int idx_m = (idx0 + idx1 + 1)/2;
-		if(value.x <= arr->data[idx_m].x && value.x > arr->data[idx_m-1].x) {
-			ins_idx = idx_m;
-		}
-
-		if(value.x > arr->data[idx_m].x) idx0 = idx_m;
-		else idx1 = idx_m;
-	}
+	int ins_idx = (int) data_array2_lower_bound_x(arr, value.x);
 
 	if(value.x != arr->data[ins_idx].x) return ins_idx;
 
@@ -367,6 +570,7 @@ int data_array3_idx_from_binary_search(DataArray3 *arr, Vector3 value) {
 }
 
 void data_array1_insert_new(DataArray1 *arr, double value) {
+	data_array1_make_writable(arr);
 	check_data_array1_add_capacity(arr);
 
 	int insert_index = data_array1_idx_from_binary_search(arr, value);
@@ -379,9 +583,11 @@ void data_array1_insert_new(DataArray1 *arr, double value) {
 
 	arr->data[insert_index] = value;
 	arr->count++;
+	data_array1_aggregates_add(arr, value);
 }
 
 void data_array2_insert_new(DataArray2 *arr, Vector2 value) {
+	data_array2_make_writable(arr);
 	check_data_array2_add_capacity(arr);
 
 	int insert_index = data_array2_idx_from_binary_search(arr, value);
@@ -394,9 +600,12 @@ void data_array2_insert_new(DataArray2 *arr, Vector2 value) {
 	
 	arr->data[insert_index] = value;
 	arr->count++;
+	data_array2_aggregates_add(arr, value);
+	arr->spacing.valid = false;
 }
 
 void data_array3_insert_new(DataArray3 *arr, Vector3 value) {
+	data_array3_make_writable(arr);
 	check_data_array3_add_capacity(arr);
 
 	int insert_index = data_array3_idx_from_binary_search(arr, value);
@@ -409,22 +618,30 @@ void data_array3_insert_new(DataArray3 *arr, Vector3 value) {
 
 	arr->data[insert_index] = value;
 	arr->count++;
+	data_array3_aggregates_add(arr, value);
 }
 
 void data_array1_remove_at_idx(DataArray1 *arr, int idx) {
 	if(!arr || idx < 0 || idx >= arr->count) return;
+	data_array1_aggregates_remove(arr, idx);
+	data_array1_make_writable(arr);
 	memmove(arr->data+idx, arr->data+idx+1, (arr->count-idx-1) * sizeof(double));
 	arr->count--;
 }
 
 void data_array2_remove_at_idx(DataArray2 *arr, int idx) {
 	if(!arr || idx < 0 || idx >= arr->count) return;
+	data_array2_aggregates_remove(arr, idx);
+	data_array2_make_writable(arr);
 	memmove(arr->data+idx, arr->data+idx+1, (arr->count-idx-1) * sizeof(Vector2));
 	arr->count--;
+	arr->spacing.valid = false;
 }
 
 void data_array3_remove_at_idx(DataArray3 *arr, int idx) {
 	if(!arr || idx < 0 || idx >= arr->count) return;
+	data_array3_aggregates_remove(arr, idx);
+	data_array3_make_writable(arr);
 	memmove(arr->data+idx, arr->data+idx+1, (arr->count-idx-1) * sizeof(Vector3));
 	arr->count--;
 }
@@ -459,64 +676,301 @@ bool data_array3_remove_by_value(DataArray3 *arr, Vector3 val) {
 	return false;
 }
 
-double data_array1_get_max(DataArray1 *arr) {
-	if(!arr || arr->count == 0) return NAN;
-	double max = arr->data[0];
-	for(int i = 1; i < arr->count; i++) {
-		if(max < arr->data[i]) max = arr->data[i];
+typedef struct MinMaxJob {
+	const double *data;
+	size_t num_elem;
+	int num_comp;
+	size_t num_chunks;
+	double (*min)[3];
+	double (*max)[3];
+} MinMaxJob;
+
+static void minmax_interleaved_serial(const double *data, size_t num_elem, int num_comp, double *min, double *max) {
+	// constant num_comp for each call to get specialized kernels
+	switch(num_comp) {
+		case 1: simd_minmax_interleaved(data, num_elem, 1, min, max); break;
+		case 2: simd_minmax_interleaved(data, num_elem, 2, min, max); break;
+		default: simd_minmax_interleaved(data, num_elem, 3, min, max); break;
 	}
-	return max;
 }
 
-double data_array1_get_min(DataArray1 *arr) {
-	if(!arr || arr->count == 0) return NAN;
-	double min = arr->data[0];
-	for(int i = 1; i < arr->count; i++) {
-		if(min > arr->data[i]) min = arr->data[i];
+static void minmax_chunk_task(void *ctx, size_t chunk) {
+	MinMaxJob *job = ctx;
+	size_t begin = job->num_elem * chunk / job->num_chunks;
+	size_t end = job->num_elem * (chunk+1) / job->num_chunks;
+	minmax_interleaved_serial(job->data + begin*job->num_comp, end-begin, job->num_comp, job->min[chunk], job->max[chunk]);
+}
+
+static void minmax_interleaved(const double *data, size_t num_elem, int num_comp, double *min, double *max) {
+	size_t num_chunks = get_num_parallel_chunks(num_elem, DATA_ARRAY_PARALLEL_MIN_CHUNK);
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		minmax_interleaved_serial(data, num_elem, num_comp, min, max);
+		return;
 	}
-	return min;
+
+	double (*chunk_min)[3] = malloc(num_chunks * sizeof(*chunk_min));
+	double (*chunk_max)[3] = malloc(num_chunks * sizeof(*chunk_max));
+	MinMaxJob job = {data, num_elem, num_comp, num_chunks, chunk_min, chunk_max};
+	run_parallel_tasks(num_chunks, minmax_chunk_task, &job);
+
+	// combined in order so that only a NaN as very first element propagates (as for the serial path)
+	for(int c = 0; c < num_comp; c++) {
+		min[c] = chunk_min[0][c];
+		max[c] = chunk_max[0][c];
+		for(size_t i = 1; i < num_chunks; i++) {
+			if(min[c] > chunk_min[i][c]) min[c] = chunk_min[i][c];
+			if(max[c] < chunk_max[i][c]) max[c] = chunk_max[i][c];
+		}
+	}
+
+	free(chunk_min);
+	free(chunk_max);
 }
 
-Vector2 data_array2_get_max(DataArray2 *arr) {
-	if(!arr || arr->count == 0) return vec2(NAN, NAN);
-	Vector2 max = arr->data[0];
-	for(int i = 1; i < arr->count; i++) {
-		if(max.x < arr->data[i].x) max.x = arr->data[i].x;
-		if(max.y < arr->data[i].y) max.y = arr->data[i].y;
+static void minmax_idx_strided(const double *data, size_t num_elem, int stride, int *min_idx, int *max_idx) {
+	int idx_min = 0, idx_max = 0;
+	double min = data[0], max = data[0];
+	for(size_t i = 1; i < num_elem; i++) {
+		double v = data[i*stride];
+		// branchless selects (first occurrence wins as comparisons are strict)
+		bool is_min = v < min, is_max = v > max;
+		min = is_min ? v : min;
+		idx_min = is_min ? (int) i : idx_min;
+		max = is_max ? v : max;
+		idx_max = is_max ? (int) i : idx_max;
 	}
-	return max;
+	if(min_idx) *min_idx = idx_min;
+	if(max_idx) *max_idx = idx_max;
+}
+
+double data_array1_get_max(DataArray1 *arr) {
+	return data_array1_get_minmax(arr).max;
+}
+
+double data_array1_get_min(DataArray1 *arr) {
+	return data_array1_get_minmax(arr).min;
+}
+
+Vector2 data_array2_get_max(DataArray2 *arr) {
+	return data_array2_get_bounds(arr).max;
 }
 
 Vector2 data_array2_get_min(DataArray2 *arr) {
-	if(!arr || arr->count == 0) return vec2(NAN, NAN);
-	Vector2 min = arr->data[0];
-	for(int i = 1; i < arr->count; i++) {
-		if(min.x > arr->data[i].x) min.x = arr->data[i].x;
-		if(min.y > arr->data[i].y) min.y = arr->data[i].y;
-	}
-	return min;
+	return data_array2_get_bounds(arr).min;
 }
 
 Vector3 data_array3_get_max(DataArray3 *arr) {
-	if(!arr || arr->count == 0) return vec3(NAN, NAN, NAN);
-	Vector3 max = arr->data[0];
-	for(int i = 1; i < arr->count; i++) {
-		if(max.x < arr->data[i].x) max.x = arr->data[i].x;
-		if(max.y < arr->data[i].y) max.y = arr->data[i].y;
-		if(max.z < arr->data[i].z) max.z = arr->data[i].z;
-	}
-	return max;
+	return data_array3_get_bounds(arr).max;
 }
 
 Vector3 data_array3_get_min(DataArray3 *arr) {
-	if(!arr || arr->count == 0) return vec3(NAN, NAN, NAN);
-	Vector3 min = arr->data[0];
-	for(int i = 1; i < arr->count; i++) {
-		if(min.x > arr->data[i].x) min.x = arr->data[i].x;
-		if(min.y > arr->data[i].y) min.y = arr->data[i].y;
-		if(min.z > arr->data[i].z) min.z = arr->data[i].z;
-	}
-	return min;
+	return data_array3_get_bounds(arr).min;
+}
+
+static DataBounds1 data_array1_compute_minmax(DataArray1 *arr) {
+	DataBounds1 bounds;
+	minmax_interleaved(arr->data, arr->count, 1, &bounds.min, &bounds.max);
+	return bounds;
+}
+
+static DataBounds2 data_array2_compute_bounds(DataArray2 *arr) {
+	double min[2], max[2];
+	minmax_interleaved((double *) arr->data, arr->count, 2, min, max);
+	return (DataBounds2) {vec2(min[0], min[1]), vec2(max[0], max[1])};
+}
+
+static DataBounds3 data_array3_compute_bounds(DataArray3 *arr) {
+	double min[3], max[3];
+	minmax_interleaved((double *) arr->data, arr->count, 3, min, max);
+	return (DataBounds3) {vec3(min[0], min[1], min[2]), vec3(max[0], max[1], max[2])};
+}
+
+static double data_array1_compute_sum(DataArray1 *arr) {
+	double sum;
+	simd_sum_interleaved(arr->data, arr->count, 1, &sum);
+	return sum;
+}
+
+static Vector2 data_array2_compute_sum(DataArray2 *arr) {
+	double sum[2];
+	simd_sum_interleaved((double *) arr->data, arr->count, 2, sum);
+	return vec2(sum[0], sum[1]);
+}
+
+static Vector3 data_array3_compute_sum(DataArray3 *arr) {
+	double sum[3];
+	simd_sum_interleaved((double *) arr->data, arr->count, 3, sum);
+	return vec3(sum[0], sum[1], sum[2]);
+}
+
+// recomputes invalidated aggregates (arrays with at least one element only)
+static void data_array1_update_aggregates(DataArray1 *arr) {
+	if(arr->aggregates.valid) return;
+	arr->aggregates.bounds = data_array1_compute_minmax(arr);
+	arr->aggregates.sum = data_array1_compute_sum(arr);
+	arr->aggregates.valid = true;
+}
+
+static void data_array2_update_aggregates(DataArray2 *arr) {
+	if(arr->aggregates.valid) return;
+	arr->aggregates.bounds = data_array2_compute_bounds(arr);
+	arr->aggregates.sum = data_array2_compute_sum(arr);
+	arr->aggregates.valid = true;
+}
+
+static void data_array3_update_aggregates(DataArray3 *arr) {
+	if(arr->aggregates.valid) return;
+	arr->aggregates.bounds = data_array3_compute_bounds(arr);
+	arr->aggregates.sum = data_array3_compute_sum(arr);
+	arr->aggregates.valid = true;
+}
+
+DataBounds1 data_array1_get_minmax(DataArray1 *arr) {
+	if(!arr || arr->count == 0) return (DataBounds1) {NAN, NAN};
+	if(!arr->aggregates.enabled) return data_array1_compute_minmax(arr);
+	data_array1_update_aggregates(arr);
+	return arr->aggregates.bounds;
+}
+
+DataBounds2 data_array2_get_bounds(DataArray2 *arr) {
+	if(!arr || arr->count == 0) return (DataBounds2) {vec2(NAN, NAN), vec2(NAN, NAN)};
+	if(!arr->aggregates.enabled) return data_array2_compute_bounds(arr);
+	data_array2_update_aggregates(arr);
+	return arr->aggregates.bounds;
+}
+
+DataBounds3 data_array3_get_bounds(DataArray3 *arr) {
+	if(!arr || arr->count == 0) return (DataBounds3) {vec3(NAN, NAN, NAN), vec3(NAN, NAN, NAN)};
+	if(!arr->aggregates.enabled) return data_array3_compute_bounds(arr);
+	data_array3_update_aggregates(arr);
+	return arr->aggregates.bounds;
+}
+
+double data_array1_get_sum(DataArray1 *arr) {
+	if(!arr || arr->count == 0) return 0;
+	if(!arr->aggregates.enabled) return data_array1_compute_sum(arr);
+	data_array1_update_aggregates(arr);
+	return arr->aggregates.sum;
+}
+
+Vector2 data_array2_get_sum(DataArray2 *arr) {
+	if(!arr || arr->count == 0) return vec2(0, 0);
+	if(!arr->aggregates.enabled) return data_array2_compute_sum(arr);
+	data_array2_update_aggregates(arr);
+	return arr->aggregates.sum;
+}
+
+Vector3 data_array3_get_sum(DataArray3 *arr) {
+	if(!arr || arr->count == 0) return vec3(0, 0, 0);
+	if(!arr->aggregates.enabled) return data_array3_compute_sum(arr);
+	data_array3_update_aggregates(arr);
+	return arr->aggregates.sum;
+}
+
+void data_array1_enable_aggregates(DataArray1 *arr, bool enable) {
+	if(!arr) return;
+	arr->aggregates.enabled = enable;
+	arr->aggregates.valid = false;
+}
+
+void data_array2_enable_aggregates(DataArray2 *arr, bool enable) {
+	if(!arr) return;
+	arr->aggregates.enabled = enable;
+	arr->aggregates.valid = false;
+}
+
+void data_array3_enable_aggregates(DataArray3 *arr, bool enable) {
+	if(!arr) return;
+	arr->aggregates.enabled = enable;
+	arr->aggregates.valid = false;
+}
+
+void data_array1_invalidate_cache(DataArray1 *arr) {
+	if(!arr) return;
+	arr->aggregates.valid = false;
+}
+
+void data_array2_invalidate_cache(DataArray2 *arr) {
+	if(!arr) return;
+	arr->aggregates.valid = false;
+	arr->spacing.valid = false;
+}
+
+void data_array3_invalidate_cache(DataArray3 *arr) {
+	if(!arr) return;
+	arr->aggregates.valid = false;
+}
+
+bool data_array2_detect_uniform_spacing(DataArray2 *arr, double tolerance) {
+	if(!arr) return false;
+	DataSpacing2 *spacing = &arr->spacing;
+	spacing->valid = true;
+	spacing->uniform = false;
+	if(arr->count < 2) return false;
+
+	double x0 = arr->data[0].x;
+	double dx = (arr->data[arr->count-1].x - x0) / (double) (arr->count-1);
+	if(!(dx > 0) || isinf(dx)) return false;
+	double max_deviation = tolerance * dx;
+	for(size_t i = 1; i < arr->count-1; i++) {
+		if(!(fabs(arr->data[i].x - (x0 + (double) i * dx)) <= max_deviation)) return false;
+	}
+	spacing->uniform = true;
+	spacing->x0 = x0;
+	spacing->inv_dx = 1 / dx;
+	return true;
+}
+
+bool data_array2_is_uniformly_spaced(DataArray2 *arr) {
+	return arr && arr->spacing.valid && arr->spacing.uniform;
+}
+
+size_t data_array2_lower_bound_x(DataArray2 *arr, double x) {
+	Vector2 *data = arr->data;
+	size_t count = arr->count;
+	if(data_array2_is_uniformly_spaced(arr)) {
+		// the index is only estimated (x may deviate within the tolerance) and corrected locally
+		double guess = ceil((x - arr->spacing.x0) * arr->spacing.inv_dx);
+		size_t idx = guess > 0 ? (guess < (double) count ? (size_t) guess : count) : 0;
+		while(idx > 0 && data[idx-1].x >= x) idx--;
+		while(idx < count && data[idx].x < x) idx++;
+		return idx;
+	}
+
+	size_t lo = 0, hi = count;
+	while(lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if(data[mid].x < x) lo = mid+1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+void data_array1_get_minmax_idx(DataArray1 *arr, int *min_idx, int *max_idx) {
+	if(!arr || arr->count == 0) {
+		if(min_idx) *min_idx = -1;
+		if(max_idx) *max_idx = -1;
+		return;
+	}
+	minmax_idx_strided(arr->data, arr->count, 1, min_idx, max_idx);
+}
+
+void data_array2_get_minmax_idx(DataArray2 *arr, int component, int *min_idx, int *max_idx) {
+	if(!arr || arr->count == 0 || component < 0 || component > 1) {
+		if(min_idx) *min_idx = -1;
+		if(max_idx) *max_idx = -1;
+		return;
+	}
+	minmax_idx_strided((double *) arr->data + component, arr->count, 2, min_idx, max_idx);
+}
+
+void data_array3_get_minmax_idx(DataArray3 *arr, int component, int *min_idx, int *max_idx) {
+	if(!arr || arr->count == 0 || component < 0 || component > 2) {
+		if(min_idx) *min_idx = -1;
+		if(max_idx) *max_idx = -1;
+		return;
+	}
+	minmax_idx_strided((double *) arr->data + component, arr->count, 3, min_idx, max_idx);
 }
 
 void print_data_array1(DataArray1 *arr, const char *x_name) {
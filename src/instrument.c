@@ -0,0 +1,109 @@
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "geometrylib_datatool.h"
+#include "instrument.h"
+
+#ifdef GEOMETRYLIB_INSTRUMENT
+
+static atomic_size_t live_arrays[4];
+static atomic_size_t allocated_bytes;
+static atomic_size_t peak_allocated_bytes;
+static atomic_size_t total_allocated_bytes;
+static atomic_size_t growth_events;
+static atomic_size_t growth_copied_bytes;
+static atomic_size_t stack_to_heap_moves;
+static atomic_size_t live_heap_buffers;
+
+static void update_peak(size_t current) {
+	size_t peak = atomic_load_explicit(&peak_allocated_bytes, memory_order_relaxed);
+	while(current > peak && !atomic_compare_exchange_weak_explicit(&peak_allocated_bytes, &peak, current, memory_order_relaxed, memory_order_relaxed));
+}
+
+void instrument_bytes_allocated(size_t num_bytes) {
+	size_t current = atomic_fetch_add_explicit(&allocated_bytes, num_bytes, memory_order_relaxed) + num_bytes;
+	atomic_fetch_add_explicit(&total_allocated_bytes, num_bytes, memory_order_relaxed);
+	update_peak(current);
+}
+
+void instrument_bytes_freed(size_t num_bytes) {
+	atomic_fetch_sub_explicit(&allocated_bytes, num_bytes, memory_order_relaxed);
+}
+
+void instrument_array_created(DataArrayType type, size_t num_bytes) {
+	atomic_fetch_add_explicit(&live_arrays[type - DATA_ARRAY_TYPE_1], 1, memory_order_relaxed);
+	instrument_bytes_allocated(num_bytes);
+}
+
+void instrument_array_freed(DataArrayType type, size_t num_bytes) {
+	atomic_fetch_sub_explicit(&live_arrays[type - DATA_ARRAY_TYPE_1], 1, memory_order_relaxed);
+	instrument_bytes_freed(num_bytes);
+}
+
+void instrument_buffer_allocated(size_t num_bytes) {
+	atomic_fetch_add_explicit(&live_heap_buffers, 1, memory_order_relaxed);
+	instrument_bytes_allocated(num_bytes);
+}
+
+void instrument_buffer_freed(size_t num_bytes) {
+	atomic_fetch_sub_explicit(&live_heap_buffers, 1, memory_order_relaxed);
+	instrument_bytes_freed(num_bytes);
+}
+
+void instrument_growth(size_t num_copied_bytes, bool from_stack_buffer) {
+	atomic_fetch_add_explicit(&growth_events, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&growth_copied_bytes, num_copied_bytes, memory_order_relaxed);
+	if(from_stack_buffer) atomic_fetch_add_explicit(&stack_to_heap_moves, 1, memory_order_relaxed);
+}
+
+DataArrayInstrumentStats data_array_get_instrument_stats() {
+	DataArrayInstrumentStats stats;
+	stats.enabled = true;
+	for(int i = 0; i < 4; i++) stats.live_arrays[i] = atomic_load(&live_arrays[i]);
+	stats.allocated_bytes = atomic_load(&allocated_bytes);
+	stats.peak_allocated_bytes = atomic_load(&peak_allocated_bytes);
+	stats.total_allocated_bytes = atomic_load(&total_allocated_bytes);
+	stats.growth_events = atomic_load(&growth_events);
+	stats.growth_copied_bytes = atomic_load(&growth_copied_bytes);
+	stats.stack_to_heap_moves = atomic_load(&stack_to_heap_moves);
+	stats.live_heap_buffers = atomic_load(&live_heap_buffers);
+	return stats;
+}
+
+void data_array_reset_instrument_stats() {
+	atomic_store(&peak_allocated_bytes, atomic_load(&allocated_bytes));
+	atomic_store(&total_allocated_bytes, 0);
+	atomic_store(&growth_events, 0);
+	atomic_store(&growth_copied_bytes, 0);
+	atomic_store(&stack_to_heap_moves, 0);
+}
+
+#else
+
+DataArrayInstrumentStats data_array_get_instrument_stats() {
+	return (DataArrayInstrumentStats) {0};
+}
+
+void data_array_reset_instrument_stats() {}
+
+#endif
+
+int data_array_instrument_stats_to_json(DataArrayInstrumentStats stats, char *buffer, size_t buffer_size) {
+	return snprintf(buffer, buffer_size,
+		"{\"enabled\": %s, "
+		"\"live_arrays\": {\"data_array1\": %zu, \"data_array2\": %zu, \"data_array3\": %zu, \"data_arrayn\": %zu}, "
+		"\"allocated_bytes\": %zu, \"peak_allocated_bytes\": %zu, \"total_allocated_bytes\": %zu, "
+		"\"growth_events\": %zu, \"growth_copied_bytes\": %zu, "
+		"\"live_heap_buffers\": %zu, \"stack_to_heap_moves\": %zu}",
+		stats.enabled ? "true" : "false",
+		stats.live_arrays[0], stats.live_arrays[1], stats.live_arrays[2], stats.live_arrays[3],
+		stats.allocated_bytes, stats.peak_allocated_bytes, stats.total_allocated_bytes,
+		stats.growth_events, stats.growth_copied_bytes,
+		stats.live_heap_buffers, stats.stack_to_heap_moves);
+}
+
+void print_data_array_instrument_stats() {
+	char buffer[1024];
+	data_array_instrument_stats_to_json(data_array_get_instrument_stats(), buffer, sizeof(buffer));
+	printf("%s\n", buffer);
+}
@@ -0,0 +1,35 @@
+#ifndef KMAT_INSTRUMENT_H
+#define KMAT_INSTRUMENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "geometrylib_databin.h"
+
+/*
+ * Allocation hooks of the data arrays; they compile to nothing unless GEOMETRYLIB_INSTRUMENT is defined.
+ */
+
+#ifdef GEOMETRYLIB_INSTRUMENT
+
+// header of an array
+void instrument_array_created(DataArrayType type, size_t num_bytes);
+void instrument_array_freed(DataArrayType type, size_t num_bytes);
+// heap buffer of a DataArray1/2/3
+void instrument_buffer_allocated(size_t num_bytes);
+void instrument_buffer_freed(size_t num_bytes);
+// memory of an array that is neither its header nor a heap buffer (e.g. the rows of a DataArrayN)
+void instrument_bytes_allocated(size_t num_bytes);
+void instrument_bytes_freed(size_t num_bytes);
+// reallocation of an array that copied num_copied_bytes into the new memory
+void instrument_growth(size_t num_copied_bytes, bool from_stack_buffer);
+
+#define INSTRUMENT(hook) hook
+
+#else
+
+#define INSTRUMENT(hook) ((void) 0)
+
+#endif
+
+#endif //KMAT_INSTRUMENT_H
@@ -1,54 +1,393 @@
 #include <math.h>
 
 #include "geometrylib_linetool.h"
+#include "geometrylib_spline.h"
 #include "data_array_def.h"
+#include "parallel.h"
+#include "simd.h"
+
+// queries whose brackets are collected before they are interpolated together
+#define INTERPOLATION_BATCH_BLOCK 256
+// segments of line0 per chunk of a parallel intersection (at least)
+#define LINE_INTERSECTION_PARALLEL_MIN_CHUNK (1 << 16)
+
+typedef struct InterpolationJob {
+	const Vector2 *data;
+	size_t num_data;
+	const double *x;
+	double *y;
+	size_t num_x;
+	size_t num_chunks;
+} InterpolationJob;
+
+typedef struct LineIntersectionJob {
+	const Vector2 *data0;
+	size_t num_segments;	// segments of line0
+	const Vector2 *data1;
+	size_t size1;
+	DataArray2 **inters;	// intersections of each chunk
+	size_t num_chunks;
+} LineIntersectionJob;
+
+// first index whose x is not smaller than x (x is sorted)
+static size_t lower_bound_x(const Vector2 *data, size_t num_data, double x) {
+	size_t lo = 0, hi = num_data;
+	while(lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if(data[mid].x < x) lo = mid+1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+static double interpolate_segment(const Vector2 *data, size_t idx0, double x) {
+	Vector2 p0 = data[idx0], p1 = data[idx0+1];
+	double m = (p1.y-p0.y) / (p1.x-p0.x);
+	return (x-p0.x) * m + p0.y;
+}
 
 double interpolate_from_sorted_data_array2(DataArray2 *data_array, double x) {
 	Vector2 *data = data_array2_get_data(data_array);
 	size_t num_data = data_array2_size(data_array);
-	if(x < data[0].x || x > data[num_data-1].x) return NAN;
+	if(num_data < 2 || x < data[0].x || x > data[num_data-1].x) return NAN;
+
+	// left point of the segment containing x (the segment ending at x for x on a point)
+	size_t idx0 = data_array2_lower_bound_x(data_array, x);
+	idx0 = idx0 > 0 ? idx0-1 : 0;
+	return interpolate_segment(data, idx0, x);
+}
 
-	int idx0 = 0, idx1 = (int) data_array->count-1;
-	while(idx1-idx0 > 1) {
-		int idx_m = (idx0 + idx1)/2;
-		if(data_array->data[idx_m].x < x == data_array->data[idx0].y < x) idx0 = idx_m;
-		else idx1 = idx_m;
+InterpolationCursor2 interpolation_cursor2(DataArray2 *data_array) {
+	return (InterpolationCursor2) {data_array, 0};
+}
+
+// hunts for the first index whose x is not smaller than x, starting at guess (O(log distance))
+static size_t hunt_lower_bound_x(const Vector2 *data, size_t num_data, double x, size_t guess) {
+	size_t lo, hi, step = 1;
+	if(data[guess].x < x) {
+		// the result lies in (lo, hi]
+		lo = guess, hi = guess+1;
+		while(hi < num_data && data[hi].x < x) {
+			lo = hi;
+			step *= 2;
+			hi = num_data-lo > step ? lo+step : num_data;
+		}
+		lo++;
+	} else {
+		// the result lies in [lo, hi]
+		lo = guess, hi = guess;
+		while(lo > 0 && data[lo-1].x >= x) {
+			hi = lo-1;
+			step *= 2;
+			lo = hi > step ? hi-step : 0;
+		}
+	}
+	while(lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if(data[mid].x < x) lo = mid+1;
+		else hi = mid;
 	}
+	return lo;
+}
 
-	Vector2 p0 = data[idx0], p1 = data[idx1];
+double interpolate_with_cursor2(InterpolationCursor2 *cursor, double x) {
+	Vector2 *data = data_array2_get_data(cursor->data_array);
+	size_t num_data = data_array2_size(cursor->data_array);
+	if(num_data < 2 || x < data[0].x || x > data[num_data-1].x) return NAN;
 
-	double m = (p1.y-p0.y) / (p1.x-p0.x);
-	return (x-p0.x) * m + p0.y;
+	// the array may have shrunk since the last query
+	size_t guess = cursor->idx+1 < num_data ? cursor->idx+1 : num_data-1;
+	size_t idx0 = data_array2_is_uniformly_spaced(cursor->data_array) ?
+		data_array2_lower_bound_x(cursor->data_array, x) : hunt_lower_bound_x(data, num_data, x, guess);
+	idx0 = idx0 > 0 ? idx0-1 : 0;
+	cursor->idx = idx0;
+	return interpolate_segment(data, idx0, x);
+}
+
+// interpolates sorted queries inside the x-range of the data with a merge walk over the data
+static void interpolate_sorted_range(const Vector2 *data, size_t num_data, const double *x, double *y, size_t num_x) {
+	size_t idx[INTERPOLATION_BATCH_BLOCK];
+	// left point of the segment containing the first query (the segment ending at it for queries on a point)
+	size_t i = lower_bound_x(data, num_data, x[0]);
+	i = i > 0 ? i-1 : 0;
+	for(size_t begin = 0; begin < num_x; begin += INTERPOLATION_BATCH_BLOCK) {
+		size_t num_block = num_x - begin < INTERPOLATION_BATCH_BLOCK ? num_x - begin : INTERPOLATION_BATCH_BLOCK;
+		for(size_t k = 0; k < num_block; k++) {
+			while(i < num_data-2 && data[i+1].x < x[begin+k]) i++;
+			idx[k] = i;
+		}
+		simd_lerp_indexed2((const double *) data, idx, x + begin, y + begin, num_block);
+	}
+}
+
+static void interpolate_chunk_task(void *ctx, size_t chunk) {
+	InterpolationJob *job = ctx;
+	size_t begin = job->num_x * chunk / job->num_chunks;
+	size_t end = job->num_x * (chunk+1) / job->num_chunks;
+	if(end > begin) interpolate_sorted_range(job->data, job->num_data, job->x + begin, job->y + begin, end-begin);
+}
+
+void interpolate_values_from_sorted_data_array2(DataArray2 *data_array, const double *x, double *y, size_t num_x) {
+	if(num_x == 0) return;
+	const Vector2 *data = data_array->data;
+	size_t num_data = data_array->count;
+	if(num_data < 2) {
+		for(size_t k = 0; k < num_x; k++) y[k] = NAN;
+		return;
+	}
+
+	// queries outside of the data's x-range are a prefix and a suffix of the sorted queries
+	size_t begin = 0, end = num_x;
+	while(begin < end && x[begin] < data[0].x) y[begin++] = NAN;
+	while(end > begin && x[end-1] > data[num_data-1].x) y[--end] = NAN;
+	if(begin == end) return;
+
+	size_t num_chunks = get_num_parallel_chunks(end-begin, DATA_ARRAY_PARALLEL_MIN_CHUNK);
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		interpolate_sorted_range(data, num_data, x + begin, y + begin, end-begin);
+		return;
+	}
+	InterpolationJob job = {data, num_data, x + begin, y + begin, end-begin, num_chunks};
+	run_parallel_tasks(num_chunks, interpolate_chunk_task, &job);
+}
+
+DataArray1 * interpolate_batch_from_sorted_data_array2(DataArray2 *data_array, DataArray1 *x) {
+	DataArray1 *y = data_array1_create();
+	if(!data_array || !x || x->count == 0) return y;
+	data_array1_reserve(y, x->count);
+	y->count = x->count;
+	interpolate_values_from_sorted_data_array2(data_array, x->data, y->data, x->count);
+	return y;
+}
+
+Vector2 get_line_segment_intersection(Vector2 u0, Vector2 u1, Vector2 v0, Vector2 v1) {
+	// signed distances (scaled) of u0 and u1 to the line through v0 and v1
+	double o0 = orientation2(v0, v1, u0);
+	double o1 = orientation2(v0, v1, u1);
+	if(o0 != o1) {
+		double t = o0 / (o0 - o1);
+		if(t < 0) t = 0;
+		if(t > 1) t = 1;
+		return add_vec2(u0, scale_vec2(subtract_vec2(u1, u0), t));
+	}
+	// parallel: the first endpoint lying on the other segment (for collinear, overlapping segments)
+	if(o0 == 0) {
+		if(on_segment2(u0, u1, v0)) return v0;
+		if(on_segment2(u0, u1, v1)) return v1;
+		if(on_segment2(v0, v1, u0)) return u0;
+		if(on_segment2(v0, v1, u1)) return u1;
+	}
+	return vec2(NAN, NAN);
+}
+
+// sweep over x for the segments begin..end-1 of line0: the window of line1's segments whose x-intervals overlap
+// the current segment of line0 only moves forward, so each segment is passed once (apart from segments sharing
+// the same x-values)
+static void intersect_sorted_lines_range(const Vector2 *data0, size_t begin, size_t end, const Vector2 *data1, size_t size1, DataArray2 *inters_points) {
+	// first segment of line1 that does not end before the first segment of the range starts
+	size_t j_start = lower_bound_x(data1+1, size1-1, data0[begin].x);
+	for(size_t i = begin; i < end; i++) {
+		Vector2 u0 = data0[i], u1 = data0[i+1];
+		while(j_start < size1-1 && data1[j_start+1].x < u0.x) j_start++;
+		for(size_t j = j_start; j < size1-1 && data1[j].x <= u1.x; j++) {
+			if(are_line_segments_intersecting2(u0, u1, data1[j], data1[j+1])) {
+				data_array2_append_new(inters_points, get_line_segment_intersection(u0, u1, data1[j], data1[j+1]));
+			}
+		}
+	}
+}
+
+static void intersect_lines_chunk_task(void *ctx, size_t chunk) {
+	LineIntersectionJob *job = ctx;
+	size_t begin = job->num_segments * chunk / job->num_chunks;
+	size_t end = job->num_segments * (chunk+1) / job->num_chunks;
+	job->inters[chunk] = data_array2_create();
+	if(end > begin) intersect_sorted_lines_range(job->data0, begin, end, job->data1, job->size1, job->inters[chunk]);
 }
 
 DataArray2 * get_line_intersections(DataArray2 *line0, DataArray2 *line1) {
 	size_t size0 = data_array2_size(line0);
 	size_t size1 = data_array2_size(line1);
+
+	if(size0 < 2 || size1 < 2) return data_array2_create();
+
+	size_t num_chunks = get_num_parallel_chunks(size0-1, LINE_INTERSECTION_PARALLEL_MIN_CHUNK);
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		DataArray2 *inters_points = data_array2_create();
+		intersect_sorted_lines_range(line0->data, 0, size0-1, line1->data, size1, inters_points);
+		return inters_points;
+	}
+
+	// every pair of segments belongs to the chunk of its segment of line0, so chunks never report the same
+	// intersection twice and their concatenation is the serial result
+	DataArray2 **chunk_inters = malloc(num_chunks * sizeof(DataArray2 *));
+	LineIntersectionJob job = {line0->data, size0-1, line1->data, size1, chunk_inters, num_chunks};
+	run_parallel_tasks(num_chunks, intersect_lines_chunk_task, &job);
+
+	size_t num_inters = 0;
+	for(size_t c = 0; c < num_chunks; c++) num_inters += chunk_inters[c]->count;
+	DataArray2 *inters_points = data_array2_create();
+	data_array2_reserve(inters_points, num_inters);
+	for(size_t c = 0; c < num_chunks; c++) {
+		for(size_t k = 0; k < chunk_inters[c]->count; k++) data_array2_append_new(inters_points, chunk_inters[c]->data[k]);
+		data_array2_free(chunk_inters[c]);
+	}
+	free(chunk_inters);
+	return inters_points;
+}
+
+DataArray2 * get_line_intersections_brute_force(DataArray2 *line0, DataArray2 *line1) {
+	size_t size0 = data_array2_size(line0);
+	size_t size1 = data_array2_size(line1);
 	DataArray2 *inters_points = data_array2_create();
 
 	if(size0 == 0 || size1 == 0) return inters_points;
 
-	int init_j = 0;
-
 	for(int i = 0; i < size0-1; i++) {
-		for(int j = init_j; j < size1-1; j++) {
+		for(int j = 0; j < size1-1; j++) {
 			if(are_line_segments_intersecting2(line0->data[i], line0->data[i+1], line1->data[j], line1->data[j+1])) {
-				Vector2 u0 = line0->data[i];
-				Vector2 u1 = line0->data[i+1];
-				Vector2 v0 = line1->data[j];
-				Vector2 v1 = line1->data[j+1];
-
-				double m0 = (u1.y - u0.y)/(u1.x - u0.x);
-				double m1 = (v1.y - v0.y)/(v1.x - v0.x);
-
-				double n0 = u0.y - m0*u0.x;
-				double n1 = v0.y - m1*v0.x;
-				double x_inters = (n0-n1)/(m1-m0);
-				double y_inters = m0*x_inters + n0;
-				data_array2_append_new(inters_points, vec2(x_inters, y_inters));
+				Vector2 inters = get_line_segment_intersection(line0->data[i], line0->data[i+1], line1->data[j], line1->data[j+1]);
+				data_array2_append_new(inters_points, inters);
 			}
 		}
 	}
 
 	return inters_points;
 }
+
+static double apply_piecewise_operation(double f, double g, PiecewiseLinearOperation operation) {
+	switch(operation) {
+		case PIECEWISE_ADD: return f + g;
+		case PIECEWISE_SUBTRACT: return f - g;
+		case PIECEWISE_MULTIPLY: return f * g;
+		case PIECEWISE_MIN: return f < g ? f : g;
+		case PIECEWISE_MAX: return f > g ? f : g;
+		default: return fabs(f - g);
+	}
+}
+
+// value at x of the function whose next unmerged point is idx (x lies in the segment ending there)
+static double evaluate_at_merge_point(const Vector2 *data, size_t idx, double x) {
+	return data[idx].x == x ? data[idx].y : interpolate_segment(data, idx-1, x);
+}
+
+DataArray2 * combine_sorted_data_arrays2(DataArray2 *f, DataArray2 *g, PiecewiseLinearOperation operation) {
+	DataArray2 *result = data_array2_create();
+	size_t num_f = data_array2_size(f), num_g = data_array2_size(g);
+	if(num_f < 2 || num_g < 2) return result;
+	const Vector2 *data_f = f->data, *data_g = g->data;
+	double x_begin = fmax(data_f[0].x, data_g[0].x), x_end = fmin(data_f[num_f-1].x, data_g[num_g-1].x);
+	if(x_begin > x_end) return result;
+
+	size_t i = lower_bound_x(data_f, num_f, x_begin), j = lower_bound_x(data_g, num_g, x_begin);
+	data_array2_reserve(result, num_f - i + num_g - j);
+	double prev_x = NAN, prev_f = NAN, prev_g = NAN;
+
+	// merge walk over both grids; between two merged x-values both functions are linear
+	while(i < num_f && j < num_g) {
+		double x = fmin(data_f[i].x, data_g[j].x);
+		if(x > x_end) break;
+		double value_f = evaluate_at_merge_point(data_f, i, x), value_g = evaluate_at_merge_point(data_g, j, x);
+
+		double prev_diff = prev_f - prev_g, diff = value_f - value_g;
+		if(prev_x < x && ((prev_diff < 0 && diff > 0) || (prev_diff > 0 && diff < 0))) {
+			double t = prev_diff / (prev_diff - diff);
+			double cross_f = prev_f + t * (value_f - prev_f), cross_g = prev_g + t * (value_g - prev_g);
+			data_array2_append_new(result, vec2(prev_x + t * (x - prev_x), apply_piecewise_operation(cross_f, cross_g, operation)));
+		}
+		data_array2_append_new(result, vec2(x, apply_piecewise_operation(value_f, value_g, operation)));
+
+		if(data_f[i].x == x) i++;
+		if(data_g[j].x == x) j++;
+		prev_x = x;
+		prev_f = value_f;
+		prev_g = value_g;
+	}
+
+	return result;
+}
+
+
+// y of the nearest point for sorted queries inside the x-range of the data with a merge walk over the data
+static void nearest_sorted_range(const Vector2 *data, size_t num_data, const double *x, double *y, size_t num_x) {
+	// first point that is not left of the current query
+	size_t i = lower_bound_x(data, num_data, x[0]);
+	for(size_t k = 0; k < num_x; k++) {
+		while(i < num_data-1 && data[i].x < x[k]) i++;
+		bool left = i > 0 && x[k] - data[i-1].x <= data[i].x - x[k];
+		y[k] = left ? data[i-1].y : data[i].y;
+	}
+}
+
+static void nearest_chunk_task(void *ctx, size_t chunk) {
+	InterpolationJob *job = ctx;
+	size_t begin = job->num_x * chunk / job->num_chunks;
+	size_t end = job->num_x * (chunk+1) / job->num_chunks;
+	if(end > begin) nearest_sorted_range(job->data, job->num_data, job->x + begin, job->y + begin, end-begin);
+}
+
+static void nearest_values_from_sorted_data_array2(DataArray2 *data_array, const double *x, double *y, size_t num_x) {
+	const Vector2 *data = data_array->data;
+	size_t num_data = data_array->count;
+	size_t begin = 0, end = num_x;
+	if(num_data > 0) {
+		while(begin < end && x[begin] < data[0].x) y[begin++] = NAN;
+		while(end > begin && x[end-1] > data[num_data-1].x) y[--end] = NAN;
+	}
+	if(num_data < 2) {
+		for(size_t k = begin; k < end; k++) y[k] = num_data == 1 ? data[0].y : NAN;
+		return;
+	}
+	if(begin == end) return;
+
+	size_t num_chunks = get_num_parallel_chunks(end-begin, DATA_ARRAY_PARALLEL_MIN_CHUNK);
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		nearest_sorted_range(data, num_data, x + begin, y + begin, end-begin);
+		return;
+	}
+	InterpolationJob job = {data, num_data, x + begin, y + begin, end-begin, num_chunks};
+	run_parallel_tasks(num_chunks, nearest_chunk_task, &job);
+}
+
+static void resample_values(DataArray2 *data_array, const double *x, double *y, size_t num_x, ResampleMode mode) {
+	if(mode == RESAMPLE_LINEAR) {
+		interpolate_values_from_sorted_data_array2(data_array, x, y, num_x);
+	} else if(mode == RESAMPLE_NEAREST) {
+		nearest_values_from_sorted_data_array2(data_array, x, y, num_x);
+	} else {
+		SplineType type = mode == RESAMPLE_AKIMA ? SPLINE_AKIMA : mode == RESAMPLE_PCHIP ? SPLINE_PCHIP : SPLINE_NATURAL_CUBIC;
+		SplineTable *table = spline_table_create(data_array, type);
+		spline_table_evaluate_values(table, x, y, num_x);
+		spline_table_free(table);
+	}
+}
+
+static DataArray2 * resample_onto_grid(DataArray2 *data_array, const double *x, size_t num_x, ResampleMode mode) {
+	DataArray2 *resampled = data_array2_create();
+	if(num_x == 0) return resampled;
+	double *y = malloc(num_x * sizeof(double));
+	if(data_array) {
+		resample_values(data_array, x, y, num_x, mode);
+	} else {
+		for(size_t k = 0; k < num_x; k++) y[k] = NAN;
+	}
+	data_array2_reserve(resampled, num_x);
+	for(size_t k = 0; k < num_x; k++) resampled->data[k] = vec2(x[k], y[k]);
+	resampled->count = num_x;
+	free(y);
+	return resampled;
+}
+
+DataArray2 * resample_sorted_data_array2(DataArray2 *data_array, DataArray1 *x, ResampleMode mode) {
+	if(!x) return data_array2_create();
+	return resample_onto_grid(data_array, x->data, x->count, mode);
+}
+
+DataArray2 * resample_sorted_data_array2_uniform(DataArray2 *data_array, double x0, double dx, size_t num_x, ResampleMode mode) {
+	double *x = malloc((num_x ? num_x : 1) * sizeof(double));
+	// multiplied instead of accumulated, so grid points do not drift
+	for(size_t k = 0; k < num_x; k++) x[k] = x0 + (double) k * dx;
+	DataArray2 *resampled = resample_onto_grid(data_array, x, num_x, mode);
+	free(x);
+	return resampled;
+}
@@ -0,0 +1,82 @@
+#include "parallel.h"
+#include "geometrylib.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define PARALLEL_MAX_THREADS 64
+#define PARALLEL_MAX_CHUNKS 256
+
+static atomic_int num_threads_setting = 0;
+
+typedef struct ParallelJob {
+	ParallelTask task;
+	void *ctx;
+	size_t num_tasks;
+	atomic_size_t next_task;
+} ParallelJob;
+
+void geometrylib_set_num_threads(int num_threads) {
+	atomic_store(&num_threads_setting, num_threads < 0 ? 0 : num_threads);
+}
+
+int get_num_parallel_threads() {
+	int num_threads = atomic_load(&num_threads_setting);
+	if(num_threads <= 0) {
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		long num_cpus = (long) info.dwNumberOfProcessors;
+#else
+		long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		num_threads = num_cpus > 0 ? (int) num_cpus : 1;
+	}
+	if(num_threads > PARALLEL_MAX_THREADS) num_threads = PARALLEL_MAX_THREADS;
+	return num_threads;
+}
+
+static void * parallel_worker(void *arg) {
+	ParallelJob *job = arg;
+	size_t task_idx;
+	while((task_idx = atomic_fetch_add(&job->next_task, 1)) < job->num_tasks) {
+		job->task(job->ctx, task_idx);
+	}
+	return NULL;
+}
+
+void run_parallel_tasks(size_t num_tasks, ParallelTask task, void *ctx) {
+	if(num_tasks == 0) return;
+
+	size_t num_threads = get_num_parallel_threads();
+	if(num_threads > num_tasks) num_threads = num_tasks;
+
+	ParallelJob job = {.task = task, .ctx = ctx, .num_tasks = num_tasks};
+	atomic_init(&job.next_task, 0);
+
+	pthread_t threads[PARALLEL_MAX_THREADS];
+	size_t num_started = 0;
+	for(size_t i = 1; i < num_threads; i++) {
+		if(pthread_create(&threads[num_started], NULL, parallel_worker, &job) != 0) break;
+		num_started++;
+	}
+
+	// the calling thread works as well (and does everything if no thread could be started)
+	parallel_worker(&job);
+
+	for(size_t i = 0; i < num_started; i++) pthread_join(threads[i], NULL);
+}
+
+size_t get_num_parallel_chunks(size_t num_elem, size_t min_chunk_size) {
+	if(min_chunk_size == 0) min_chunk_size = 1;
+	size_t num_chunks = num_elem / min_chunk_size;
+	if(num_chunks < 1) num_chunks = 1;
+	if(num_chunks > PARALLEL_MAX_CHUNKS) num_chunks = PARALLEL_MAX_CHUNKS;
+	return num_chunks;
+}
@@ -0,0 +1,39 @@
+#ifndef KMAT_PARALLEL_H
+#define KMAT_PARALLEL_H
+
+#include <stddef.h>
+
+/**
+ * @brief Task callback for run_parallel_tasks (task_idx in [0, num_tasks))
+ */
+typedef void (*ParallelTask)(void *ctx, size_t task_idx);
+
+/**
+ * @brief Returns the number of threads parallel paths may use (at least 1)
+ */
+int get_num_parallel_threads();
+
+/**
+ * @brief Runs num_tasks tasks distributed over the available threads and waits for all of them
+ *
+ * The calling thread participates. Tasks are handed out in increasing order, so callers that write
+ * results per task index get deterministic output regardless of thread count.
+ *
+ * @param num_tasks Number of tasks
+ * @param task Task callback
+ * @param ctx Context passed to every task
+ */
+void run_parallel_tasks(size_t num_tasks, ParallelTask task, void *ctx);
+
+/**
+ * @brief Returns the number of equally sized chunks a range of num_elem elements should be split into
+ *
+ * Depends only on num_elem and min_chunk_size (not on thread count) to keep chunked results deterministic.
+ *
+ * @param num_elem Number of elements
+ * @param min_chunk_size Minimum number of elements per chunk
+ * @return Number of chunks (at least 1)
+ */
+size_t get_num_parallel_chunks(size_t num_elem, size_t min_chunk_size);
+
+#endif //KMAT_PARALLEL_H
@@ -0,0 +1,1095 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "geometrylib_polyline.h"
+#include "geometrylib_linetool.h"
+#include "data_array_def.h"
+#include "parallel.h"
+
+// chains are also split after this many segments, so that their bounding boxes stay tight (e.g. for nested loops)
+#define POLYLINE_MAX_CHAIN_SEGMENTS 64
+// chains per chunk of a parallel sweep (at least)
+#define POLYLINE_PARALLEL_MIN_CHAINS (1 << 12)
+// maximal number of chains per leaf of the chain hierarchy
+#define CHAIN_HIERARCHY_LEAF_SIZE 8
+// enough for the depth of a hierarchy split at medians
+#define CHAIN_HIERARCHY_MAX_DEPTH 64
+
+// maximal run of segments of a polyline along which x does not change direction
+typedef struct MonotoneChain {
+	int line;
+	size_t first;		// index of the first point
+	size_t last;		// index of the last point (the chain spans the segments first..last-1)
+	bool decreasing;	// x decreases along the chain
+	double min_x, max_x, min_y, max_y;
+} MonotoneChain;
+
+typedef struct SegmentIntersection {
+	size_t segment0;
+	size_t segment1;
+	Vector2 point;
+} SegmentIntersection;
+
+typedef struct PolylineSweep {
+	Vector2 *data[2];
+	size_t size[2];
+	bool self;		// both lines are the same polyline
+	bool closed;	// (self only) first and last point of the polyline coincide
+	SegmentIntersection *inters;
+	size_t num_inters;
+	size_t capacity;
+} PolylineSweep;
+
+// chain index with the center of its bounding box (sort key while building the hierarchy)
+typedef struct ChainCenter {
+	double x, y;
+	size_t chain;
+} ChainCenter;
+
+typedef struct ChainHierarchyNode {
+	double min_x, max_x, min_y, max_y;
+	size_t min_chain;	// smallest chain index in the subtree
+	size_t first;		// leaf: first entry of order, inner node: index of the right child (the left child follows the node)
+	size_t count;		// leaf: number of chains, inner node: 0
+} ChainHierarchyNode;
+
+// bounding boxes of the chains split at the median of the longer side, for queries by x- and y-range
+typedef struct ChainHierarchy {
+	size_t *order;		// chain indices grouped by leaf
+	ChainHierarchyNode *nodes;
+} ChainHierarchy;
+
+typedef struct ChainSweepJob {
+	MonotoneChain *chains;
+	size_t num_chains;
+	ChainHierarchy *tree;
+	PolylineSweep *sweeps;	// sweep state (and intersections) of each chunk
+	size_t num_chunks;
+} ChainSweepJob;
+
+
+/*
+ * ------------------------------------
+ * Monotone Chains
+ * ------------------------------------
+ */
+
+static void append_monotone_chain(MonotoneChain **chains, size_t *num_chains, size_t *capacity, MonotoneChain chain, Vector2 *data) {
+	chain.min_x = chain.max_x = data[chain.first].x;
+	chain.min_y = chain.max_y = data[chain.first].y;
+	for(size_t i = chain.first+1; i <= chain.last; i++) {
+		chain.min_x = fmin(chain.min_x, data[i].x);
+		chain.max_x = fmax(chain.max_x, data[i].x);
+		chain.min_y = fmin(chain.min_y, data[i].y);
+		chain.max_y = fmax(chain.max_y, data[i].y);
+	}
+	if(*num_chains == *capacity) {
+		*capacity = *capacity ? *capacity * 2 : 64;
+		*chains = realloc(*chains, *capacity * sizeof(MonotoneChain));
+	}
+	(*chains)[(*num_chains)++] = chain;
+}
+
+// splits a polyline into short x-monotone chains (segments without change in x join either direction)
+static void split_monotone_chains(int line, Vector2 *data, size_t size, MonotoneChain **chains, size_t *num_chains, size_t *capacity) {
+	if(size < 2) return;
+	MonotoneChain chain = {.line = line, .first = 0};
+	int direction = 0;
+	for(size_t i = 0; i < size-1; i++) {
+		int segment_direction = (data[i+1].x > data[i].x) - (data[i+1].x < data[i].x);
+		bool turning = segment_direction != 0 && direction != 0 && segment_direction != direction;
+		if(turning || i - chain.first == POLYLINE_MAX_CHAIN_SEGMENTS) {
+			chain.last = i;
+			chain.decreasing = direction < 0;
+			append_monotone_chain(chains, num_chains, capacity, chain, data);
+			chain.first = i;
+			direction = 0;
+		}
+		if(segment_direction != 0) direction = segment_direction;
+	}
+	chain.last = size-1;
+	chain.decreasing = direction < 0;
+	append_monotone_chain(chains, num_chains, capacity, chain, data);
+}
+
+static int compare_chains_by_min_x(const void *a, const void *b) {
+	const MonotoneChain *c0 = a, *c1 = b;
+	if(c0->min_x != c1->min_x) return c0->min_x < c1->min_x ? -1 : 1;
+	if(c0->line != c1->line) return c0->line - c1->line;
+	return (c0->first > c1->first) - (c0->first < c1->first);
+}
+
+
+/*
+ * ------------------------------------
+ * Segment Pairs
+ * ------------------------------------
+ */
+
+static void add_segment_intersection(PolylineSweep *sweep, size_t segment0, size_t segment1, Vector2 point) {
+	if(sweep->num_inters == sweep->capacity) {
+		sweep->capacity = sweep->capacity ? sweep->capacity * 2 : 64;
+		sweep->inters = realloc(sweep->inters, sweep->capacity * sizeof(SegmentIntersection));
+	}
+	sweep->inters[sweep->num_inters++] = (SegmentIntersection) {segment0, segment1, point};
+}
+
+static bool are_segments_adjacent(PolylineSweep *sweep, size_t segment0, size_t segment1) {
+	if(!sweep->self) return false;
+	if(segment0 == segment1 || segment0+1 == segment1 || segment1+1 == segment0) return true;
+	size_t last_segment = sweep->size[0]-2;
+	return sweep->closed && ((segment0 == 0 && segment1 == last_segment) || (segment1 == 0 && segment0 == last_segment));
+}
+
+static void test_segment_pair(PolylineSweep *sweep, size_t segment0, size_t segment1) {
+	if(are_segments_adjacent(sweep, segment0, segment1)) return;
+	Vector2 u0 = sweep->data[0][segment0], u1 = sweep->data[0][segment0+1];
+	Vector2 v0 = sweep->data[1][segment1], v1 = sweep->data[1][segment1+1];
+	if(!are_line_segments_intersecting2(u0, u1, v0, v1)) return;
+
+	// segments are half-open (except the last one of a polyline): a crossing at a vertex is only
+	// reported by the segment starting there, not by the one ending there
+	if(segment0 < sweep->size[0]-2 && orientation2(v0, v1, u1) == 0 && orientation2(v0, v1, u0) != 0) return;
+	if(segment1 < sweep->size[1]-2 && orientation2(u0, u1, v1) == 0 && orientation2(u0, u1, v0) != 0) return;
+
+	if(sweep->self && segment1 < segment0) add_segment_intersection(sweep, segment1, segment0, get_line_segment_intersection(v0, v1, u0, u1));
+	else add_segment_intersection(sweep, segment0, segment1, get_line_segment_intersection(u0, u1, v0, v1));
+}
+
+// index of the k-th segment of a chain in ascending x
+static size_t chain_segment(MonotoneChain *chain, size_t k) {
+	return chain->decreasing ? chain->last-1 - k : chain->first + k;
+}
+
+static double chain_segment_min_x(Vector2 *data, size_t segment) {return fmin(data[segment].x, data[segment+1].x);}
+static double chain_segment_max_x(Vector2 *data, size_t segment) {return fmax(data[segment].x, data[segment+1].x);}
+
+// first segment (in ascending x) of a chain that does not end before x
+static size_t find_chain_segment(Vector2 *data, MonotoneChain *chain, double x) {
+	size_t lo = 0, hi = chain->last - chain->first;
+	while(lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if(chain_segment_max_x(data, chain_segment(chain, mid)) < x) lo = mid+1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// sweep over two x-monotone chains, limited to their common x-range: the window of chain1's segments
+// overlapping the current segment of chain0 only moves forward
+static void intersect_monotone_chains(PolylineSweep *sweep, MonotoneChain *chain0, MonotoneChain *chain1) {
+	Vector2 *data0 = sweep->data[chain0->line], *data1 = sweep->data[chain1->line];
+	size_t num_segments0 = chain0->last - chain0->first, num_segments1 = chain1->last - chain1->first;
+	double overlap_min_x = fmax(chain0->min_x, chain1->min_x), overlap_max_x = fmin(chain0->max_x, chain1->max_x);
+	size_t k_start = find_chain_segment(data1, chain1, overlap_min_x);
+	for(size_t i = find_chain_segment(data0, chain0, overlap_min_x); i < num_segments0; i++) {
+		size_t segment0 = chain_segment(chain0, i);
+		double min_x = chain_segment_min_x(data0, segment0), max_x = chain_segment_max_x(data0, segment0);
+		if(min_x > overlap_max_x) break;
+		while(k_start < num_segments1 && chain_segment_max_x(data1, chain_segment(chain1, k_start)) < min_x) k_start++;
+		for(size_t k = k_start; k < num_segments1; k++) {
+			size_t segment1 = chain_segment(chain1, k);
+			if(chain_segment_min_x(data1, segment1) > max_x) break;
+			// a chain swept against itself (self-intersections along vertical runs) tests each pair once
+			if(chain0 == chain1 && segment1 <= segment0) continue;
+			if(chain0->line == 0) test_segment_pair(sweep, segment0, segment1);
+			else test_segment_pair(sweep, segment1, segment0);
+		}
+	}
+}
+
+static int compare_segment_intersections(const void *a, const void *b) {
+	const SegmentIntersection *i0 = a, *i1 = b;
+	if(i0->segment0 != i1->segment0) return i0->segment0 < i1->segment0 ? -1 : 1;
+	return (i0->segment1 > i1->segment1) - (i0->segment1 < i1->segment1);
+}
+
+
+/*
+ * ------------------------------------
+ * Chain Sweep
+ * ------------------------------------
+ */
+
+static int compare_chain_centers_by_x(const void *a, const void *b) {
+	const ChainCenter *c0 = a, *c1 = b;
+	if(c0->x != c1->x) return c0->x < c1->x ? -1 : 1;
+	return (c0->chain > c1->chain) - (c0->chain < c1->chain);
+}
+
+static int compare_chain_centers_by_y(const void *a, const void *b) {
+	const ChainCenter *c0 = a, *c1 = b;
+	if(c0->y != c1->y) return c0->y < c1->y ? -1 : 1;
+	return (c0->chain > c1->chain) - (c0->chain < c1->chain);
+}
+
+static size_t count_chain_hierarchy_nodes(size_t num_chains) {
+	if(num_chains <= CHAIN_HIERARCHY_LEAF_SIZE) return 1;
+	return 1 + count_chain_hierarchy_nodes(num_chains/2) + count_chain_hierarchy_nodes(num_chains - num_chains/2);
+}
+
+// builds the subtree of centers[first..first+count-1] at node_idx and returns the index after the subtree
+static size_t build_chain_hierarchy_node(ChainHierarchy *tree, MonotoneChain *chains, ChainCenter *centers, size_t node_idx, size_t first, size_t count) {
+	ChainHierarchyNode *node = &tree->nodes[node_idx];
+	*node = (ChainHierarchyNode) {.min_x = INFINITY, .max_x = -INFINITY, .min_y = INFINITY, .max_y = -INFINITY, .min_chain = SIZE_MAX};
+	for(size_t i = first; i < first+count; i++) {
+		MonotoneChain *chain = &chains[centers[i].chain];
+		node->min_x = fmin(node->min_x, chain->min_x);
+		node->max_x = fmax(node->max_x, chain->max_x);
+		node->min_y = fmin(node->min_y, chain->min_y);
+		node->max_y = fmax(node->max_y, chain->max_y);
+		if(centers[i].chain < node->min_chain) node->min_chain = centers[i].chain;
+	}
+	if(count <= CHAIN_HIERARCHY_LEAF_SIZE) {
+		node->first = first;
+		node->count = count;
+		for(size_t i = first; i < first+count; i++) tree->order[i] = centers[i].chain;
+		return node_idx+1;
+	}
+	bool split_x = node->max_x - node->min_x >= node->max_y - node->min_y;
+	qsort(centers + first, count, sizeof(ChainCenter), split_x ? compare_chain_centers_by_x : compare_chain_centers_by_y);
+	size_t right = build_chain_hierarchy_node(tree, chains, centers, node_idx+1, first, count/2);
+	size_t next = build_chain_hierarchy_node(tree, chains, centers, right, first + count/2, count - count/2);
+	tree->nodes[node_idx].first = right;
+	return next;
+}
+
+static void build_chain_hierarchy(ChainHierarchy *tree, MonotoneChain *chains, size_t num_chains) {
+	ChainCenter *centers = malloc(num_chains * sizeof(ChainCenter));
+	for(size_t c = 0; c < num_chains; c++) {
+		centers[c] = (ChainCenter) {(chains[c].min_x + chains[c].max_x) / 2, (chains[c].min_y + chains[c].max_y) / 2, c};
+	}
+	tree->order = malloc(num_chains * sizeof(size_t));
+	tree->nodes = malloc(count_chain_hierarchy_nodes(num_chains) * sizeof(ChainHierarchyNode));
+	build_chain_hierarchy_node(tree, chains, centers, 0, 0, num_chains);
+	free(centers);
+}
+
+static void free_chain_hierarchy(ChainHierarchy *tree) {
+	free(tree->order);
+	free(tree->nodes);
+}
+
+// each chain begin..end-1 is tested against the chains before it (in x-order) whose bounding boxes overlap its own
+static void sweep_chain_range(PolylineSweep *sweep, MonotoneChain *chains, ChainHierarchy *tree, size_t begin, size_t end) {
+	for(size_t c = begin; c < end; c++) {
+		MonotoneChain *chain = &chains[c];
+		size_t stack[CHAIN_HIERARCHY_MAX_DEPTH], num_stack = 0;
+		stack[num_stack++] = 0;
+		while(num_stack > 0) {
+			ChainHierarchyNode *node = &tree->nodes[stack[--num_stack]];
+			if(node->min_chain >= c) continue;
+			if(node->max_x < chain->min_x || chain->max_x < node->min_x) continue;
+			if(node->max_y < chain->min_y || chain->max_y < node->min_y) continue;
+			if(node->count == 0) {
+				stack[num_stack++] = node->first;
+				stack[num_stack++] = node - tree->nodes + 1;
+				continue;
+			}
+			for(size_t i = node->first; i < node->first + node->count; i++) {
+				MonotoneChain *other = &chains[tree->order[i]];
+				if(tree->order[i] >= c) continue;
+				if(other->line == chain->line && !sweep->self) continue;
+				if(other->max_x < chain->min_x || chain->max_x < other->min_x) continue;
+				if(other->max_y < chain->min_y || chain->max_y < other->min_y) continue;
+				intersect_monotone_chains(sweep, other, chain);
+			}
+		}
+		if(sweep->self) intersect_monotone_chains(sweep, chain, chain);
+	}
+}
+
+static void sweep_chains_chunk_task(void *ctx, size_t chunk) {
+	ChainSweepJob *job = ctx;
+	size_t begin = job->num_chains * chunk / job->num_chunks;
+	size_t end = job->num_chains * (chunk+1) / job->num_chunks;
+	if(end > begin) sweep_chain_range(&job->sweeps[chunk], job->chains, job->tree, begin, end);
+}
+
+static DataArray2 * sweep_polylines(PolylineSweep *sweep) {
+	MonotoneChain *chains = NULL;
+	size_t num_chains = 0, capacity = 0;
+	split_monotone_chains(0, sweep->data[0], sweep->size[0], &chains, &num_chains, &capacity);
+	if(!sweep->self) split_monotone_chains(1, sweep->data[1], sweep->size[1], &chains, &num_chains, &capacity);
+	if(num_chains > 1) qsort(chains, num_chains, sizeof(MonotoneChain), compare_chains_by_min_x);
+
+	ChainHierarchy tree = {0};
+	if(num_chains > 0) build_chain_hierarchy(&tree, chains, num_chains);
+	size_t num_chunks = get_num_parallel_chunks(num_chains, POLYLINE_PARALLEL_MIN_CHAINS);
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		if(num_chains > 0) sweep_chain_range(sweep, chains, &tree, 0, num_chains);
+	} else {
+		// every pair of chains is tested by the chunk of the later one, so no intersection is found twice;
+		// the records of all chunks are merged and sorted, which does not depend on the thread count
+		ChainSweepJob job = {chains, num_chains, &tree, malloc(num_chunks * sizeof(PolylineSweep)), num_chunks};
+		for(size_t c = 0; c < num_chunks; c++) {
+			job.sweeps[c] = *sweep;
+			job.sweeps[c].inters = NULL;
+			job.sweeps[c].num_inters = job.sweeps[c].capacity = 0;
+		}
+		run_parallel_tasks(num_chunks, sweep_chains_chunk_task, &job);
+		for(size_t c = 0; c < num_chunks; c++) sweep->capacity += job.sweeps[c].num_inters;
+		sweep->inters = malloc((sweep->capacity ? sweep->capacity : 1) * sizeof(SegmentIntersection));
+		for(size_t c = 0; c < num_chunks; c++) {
+			if(job.sweeps[c].num_inters > 0) memcpy(sweep->inters + sweep->num_inters, job.sweeps[c].inters, job.sweeps[c].num_inters * sizeof(SegmentIntersection));
+			sweep->num_inters += job.sweeps[c].num_inters;
+			free(job.sweeps[c].inters);
+		}
+		free(job.sweeps);
+	}
+	free_chain_hierarchy(&tree);
+	free(chains);
+
+	if(sweep->num_inters > 1) qsort(sweep->inters, sweep->num_inters, sizeof(SegmentIntersection), compare_segment_intersections);
+	DataArray2 *inters_points = data_array2_create();
+	data_array2_reserve(inters_points, sweep->num_inters);
+	for(size_t i = 0; i < sweep->num_inters; i++) data_array2_append_new(inters_points, sweep->inters[i].point);
+	free(sweep->inters);
+	return inters_points;
+}
+
+DataArray2 * get_polyline_intersections(DataArray2 *line0, DataArray2 *line1) {
+	if(!line0 || !line1 || line0->count < 2 || line1->count < 2) return data_array2_create();
+	PolylineSweep sweep = {
+		.data = {line0->data, line1->data},
+		.size = {line0->count, line1->count}
+	};
+	return sweep_polylines(&sweep);
+}
+
+DataArray2 * get_polyline_self_intersections(DataArray2 *line) {
+	if(!line || line->count < 4) return data_array2_create();
+	Vector2 first = line->data[0], last = line->data[line->count-1];
+	PolylineSweep sweep = {
+		.data = {line->data, line->data},
+		.size = {line->count, line->count},
+		.self = true,
+		.closed = first.x == last.x && first.y == last.y
+	};
+	return sweep_polylines(&sweep);
+}
+
+
+/*
+ * ------------------------------------
+ * Simplification
+ * ------------------------------------
+ */
+
+// share of the tolerance spent on the distance to the kept line; the rest allows points beyond the kept end
+#define POLYLINE_SIMPLIFIER_LINE_SHARE 0.9
+
+// directions from the anchor whose ray passes within the line tolerance of all points since the anchor (a spherical cap)
+typedef struct DirectionCone {
+	double axis[3];
+	double half_angle;		// M_PI: unconstrained, negative: empty
+} DirectionCone;
+
+struct PolylineSimplifier {
+	double tolerance;
+	double anchor[3];		// last kept point
+	double last[3];			// last added point, kept if the next one does not fit
+	size_t last_idx;
+	DirectionCone cone;
+	double min_dist;		// smallest distance of an end from the anchor that covers the points since the anchor
+	bool has_anchor;
+	bool has_last;
+	size_t num_added;
+};
+
+// points are interleaved doubles with dim (2 or 3) components
+static double sq_distance_to_segment(const double *p, const double *a, const double *b, int dim) {
+	double ab[3], ap[3], sq_ab = 0, t = 0;
+	for(int c = 0; c < dim; c++) {
+		ab[c] = b[c] - a[c];
+		ap[c] = p[c] - a[c];
+		sq_ab += ab[c] * ab[c];
+		t += ap[c] * ab[c];
+	}
+	t = sq_ab > 0 ? fmin(fmax(t / sq_ab, 0), 1) : 0;
+	double sq_dist = 0;
+	for(int c = 0; c < dim; c++) {
+		double d = ap[c] - t * ab[c];
+		sq_dist += d * d;
+	}
+	return sq_dist;
+}
+
+static double triangle_area(const double *a, const double *b, const double *c, int dim) {
+	double u[3] = {0}, v[3] = {0};
+	for(int k = 0; k < dim; k++) {
+		u[k] = b[k] - a[k];
+		v[k] = c[k] - a[k];
+	}
+	Vector3 normal = cross_vec3(vec3(u[0], u[1], u[2]), vec3(v[0], v[1], v[2]));
+	return mag_vec3(normal) / 2;
+}
+
+static size_t simplify_rdp(const double *points, size_t n, int dim, double tolerance, size_t *indices) {
+	bool *keep = calloc(n, sizeof(bool));
+	keep[0] = keep[n-1] = true;
+	// ranges still to be split (explicit stack instead of recursion), at most n at a time
+	size_t *stack = malloc(2 * n * sizeof(size_t));
+	size_t num_stack = 0;
+	stack[num_stack++] = 0;
+	stack[num_stack++] = n-1;
+	double sq_tolerance = tolerance * tolerance;
+
+	while(num_stack > 0) {
+		size_t last = stack[--num_stack], first = stack[--num_stack];
+		double max_sq_dist = -1;
+		size_t max_idx = first;
+		for(size_t i = first+1; i < last; i++) {
+			double sq_dist = sq_distance_to_segment(points + i*dim, points + first*dim, points + last*dim, dim);
+			if(sq_dist > max_sq_dist) {
+				max_sq_dist = sq_dist;
+				max_idx = i;
+			}
+		}
+		if(max_sq_dist > sq_tolerance) {
+			keep[max_idx] = true;
+			stack[num_stack++] = first;
+			stack[num_stack++] = max_idx;
+			stack[num_stack++] = max_idx;
+			stack[num_stack++] = last;
+		}
+	}
+
+	size_t num_kept = 0;
+	for(size_t i = 0; i < n; i++) if(keep[i]) indices[num_kept++] = i;
+	free(stack);
+	free(keep);
+	return num_kept;
+}
+
+// min-heap of point indices ordered by their effective area
+typedef struct AreaHeap {
+	size_t *items;
+	size_t *position;	// heap position of every point
+	double *area;
+	size_t size;
+} AreaHeap;
+
+static void area_heap_swap(AreaHeap *heap, size_t i, size_t j) {
+	size_t tmp = heap->items[i];
+	heap->items[i] = heap->items[j];
+	heap->items[j] = tmp;
+	heap->position[heap->items[i]] = i;
+	heap->position[heap->items[j]] = j;
+}
+
+static void area_heap_sift_up(AreaHeap *heap, size_t i) {
+	while(i > 0 && heap->area[heap->items[(i-1)/2]] > heap->area[heap->items[i]]) {
+		area_heap_swap(heap, i, (i-1)/2);
+		i = (i-1)/2;
+	}
+}
+
+static void area_heap_sift_down(AreaHeap *heap, size_t i) {
+	while(true) {
+		size_t smallest = i, left = 2*i+1, right = 2*i+2;
+		if(left < heap->size && heap->area[heap->items[left]] < heap->area[heap->items[smallest]]) smallest = left;
+		if(right < heap->size && heap->area[heap->items[right]] < heap->area[heap->items[smallest]]) smallest = right;
+		if(smallest == i) return;
+		area_heap_swap(heap, i, smallest);
+		i = smallest;
+	}
+}
+
+static size_t simplify_visvalingam(const double *points, size_t n, int dim, double tolerance, size_t *indices) {
+	size_t *prev = malloc(n * sizeof(size_t)), *next = malloc(n * sizeof(size_t));
+	bool *removed = calloc(n, sizeof(bool));
+	AreaHeap heap = {malloc(n * sizeof(size_t)), malloc(n * sizeof(size_t)), malloc(n * sizeof(double)), 0};
+	for(size_t i = 0; i < n; i++) {
+		prev[i] = i-1;
+		next[i] = i+1;
+	}
+	for(size_t i = 1; i < n-1; i++) {
+		heap.area[i] = triangle_area(points + (i-1)*dim, points + i*dim, points + (i+1)*dim, dim);
+		heap.items[heap.size] = i;
+		heap.position[i] = heap.size++;
+		area_heap_sift_up(&heap, heap.size-1);
+	}
+
+	double area_threshold = tolerance * tolerance;
+	while(heap.size > 0 && heap.area[heap.items[0]] < area_threshold) {
+		size_t i = heap.items[0];
+		double removed_area = heap.area[i];
+		area_heap_swap(&heap, 0, --heap.size);
+		area_heap_sift_down(&heap, 0);
+		removed[i] = true;
+		next[prev[i]] = next[i];
+		prev[next[i]] = prev[i];
+
+		// neighbours never get a smaller effective area than the point removed before them
+		size_t neighbours[2] = {prev[i], next[i]};
+		for(int k = 0; k < 2; k++) {
+			size_t j = neighbours[k];
+			if(j == 0 || j == n-1) continue;
+			double area = triangle_area(points + prev[j]*dim, points + j*dim, points + next[j]*dim, dim);
+			heap.area[j] = fmax(area, removed_area);
+			area_heap_sift_up(&heap, heap.position[j]);
+			area_heap_sift_down(&heap, heap.position[j]);
+		}
+	}
+
+	size_t num_kept = 0;
+	for(size_t i = 0; i < n; i++) if(!removed[i]) indices[num_kept++] = i;
+	free(heap.items);
+	free(heap.position);
+	free(heap.area);
+	free(removed);
+	free(prev);
+	free(next);
+	return num_kept;
+}
+
+static double angle_between(const double *u, const double *v) {
+	double dot = u[0]*v[0] + u[1]*v[1] + u[2]*v[2];
+	return acos(fmin(fmax(dot, -1), 1));
+}
+
+// replaces the cone with the largest cap inside its intersection with the cap (axis, half_angle), O(1) per call
+static void narrow_direction_cone(DirectionCone *cone, const double *axis, double half_angle) {
+	if(cone->half_angle < 0) return;
+	if(cone->half_angle >= M_PI) {
+		memcpy(cone->axis, axis, sizeof(cone->axis));
+		cone->half_angle = half_angle;
+		return;
+	}
+	double gap = angle_between(cone->axis, axis);
+	if(gap + cone->half_angle <= half_angle) return;
+	if(gap + half_angle <= cone->half_angle) {
+		memcpy(cone->axis, axis, sizeof(cone->axis));
+		cone->half_angle = half_angle;
+		return;
+	}
+	if(gap >= cone->half_angle + half_angle) {
+		cone->half_angle = -1;
+		return;
+	}
+	// the intersection spans (gap - half_angle, cone->half_angle) on the great circle from the old to the new axis
+	double rotation = (gap + cone->half_angle - half_angle) / 2;
+	double w0 = sin(gap - rotation) / sin(gap), w1 = sin(rotation) / sin(gap);
+	for(int c = 0; c < 3; c++) cone->axis[c] = w0 * cone->axis[c] + w1 * axis[c];
+	cone->half_angle = (cone->half_angle + half_angle - gap) / 2;
+}
+
+static void polyline_simplifier_set_anchor(PolylineSimplifier *simplifier, const double *anchor) {
+	memcpy(simplifier->anchor, anchor, sizeof(simplifier->anchor));
+	simplifier->cone.half_angle = M_PI;
+	simplifier->min_dist = 0;
+	simplifier->has_anchor = true;
+	simplifier->has_last = false;
+}
+
+static void polyline_simplifier_reset(PolylineSimplifier *simplifier) {
+	simplifier->has_anchor = false;
+	simplifier->has_last = false;
+	simplifier->num_added = 0;
+}
+
+/*
+ * The segment from the anchor a to p keeps all points q since the anchor within tolerance t if its direction
+ * lies in their cone (distance h <= s*t to the line, s = POLYLINE_SIMPLIFIER_LINE_SHARE) and
+ * |p - a| >= sqrt(|q - a|² - (s*t)²) - sqrt(t² - (s*t)²), so that a q projecting beyond p is within t of p.
+ * Points within tolerance of the anchor constrain neither.
+ */
+static bool polyline_simplifier_fits(const PolylineSimplifier *simplifier, const double *p, double *dir, double *dist) {
+	double sq_dist = 0;
+	for(int c = 0; c < 3; c++) {
+		dir[c] = p[c] - simplifier->anchor[c];
+		sq_dist += dir[c] * dir[c];
+	}
+	*dist = sqrt(sq_dist);
+	if(*dist > 0) for(int c = 0; c < 3; c++) dir[c] /= *dist;
+	if(*dist < simplifier->min_dist) return false;
+	if(simplifier->cone.half_angle >= M_PI) return true;
+	return simplifier->cone.half_angle >= 0 && angle_between(simplifier->cone.axis, dir) <= simplifier->cone.half_angle;
+}
+
+// adds the next point; returns true if a point is known to be kept (copied to kept with its index)
+static bool polyline_simplifier_push(PolylineSimplifier *simplifier, const double *point, int dim, double *kept, size_t *kept_idx) {
+	size_t idx = simplifier->num_added++;
+	double p[3] = {0};
+	memcpy(p, point, dim * sizeof(double));
+
+	if(!simplifier->has_anchor) {
+		polyline_simplifier_set_anchor(simplifier, p);
+		memcpy(kept, p, sizeof(p));
+		*kept_idx = idx;
+		return true;
+	}
+
+	double dir[3], dist;
+	bool emitted = false;
+	if(!polyline_simplifier_fits(simplifier, p, dir, &dist)) {
+		// the last point that still fitted becomes the new anchor
+		memcpy(kept, simplifier->last, sizeof(p));
+		*kept_idx = simplifier->last_idx;
+		polyline_simplifier_set_anchor(simplifier, simplifier->last);
+		polyline_simplifier_fits(simplifier, p, dir, &dist);
+		emitted = true;
+	}
+
+	// p becomes the candidate end and constrains all later ends
+	memcpy(simplifier->last, p, sizeof(p));
+	simplifier->last_idx = idx;
+	simplifier->has_last = true;
+	if(dist > simplifier->tolerance) {
+		double line_tolerance = POLYLINE_SIMPLIFIER_LINE_SHARE * simplifier->tolerance;
+		double overshoot = sqrt(simplifier->tolerance * simplifier->tolerance - line_tolerance * line_tolerance);
+		simplifier->min_dist = fmax(simplifier->min_dist, sqrt(dist * dist - line_tolerance * line_tolerance) - overshoot);
+		narrow_direction_cone(&simplifier->cone, dir, asin(line_tolerance / dist));
+	}
+	return emitted;
+}
+
+// returns true if the last point is kept (copied to kept with its index) and resets the simplifier
+static bool polyline_simplifier_pop_last(PolylineSimplifier *simplifier, double *kept, size_t *kept_idx) {
+	bool has_last = simplifier->has_last;
+	if(has_last) {
+		memcpy(kept, simplifier->last, sizeof(simplifier->last));
+		*kept_idx = simplifier->last_idx;
+	}
+	polyline_simplifier_reset(simplifier);
+	return has_last;
+}
+
+static size_t simplify_streaming(const double *points, size_t n, int dim, double tolerance, size_t *indices) {
+	PolylineSimplifier *simplifier = polyline_simplifier_create(tolerance);
+	double kept[3];
+	size_t num_kept = 0;
+	for(size_t i = 0; i < n; i++) {
+		if(polyline_simplifier_push(simplifier, points + i*dim, dim, kept, &indices[num_kept])) num_kept++;
+	}
+	if(polyline_simplifier_pop_last(simplifier, kept, &indices[num_kept])) num_kept++;
+	polyline_simplifier_free(simplifier);
+	return num_kept;
+}
+
+static size_t simplify_polyline(const double *points, size_t n, int dim, double tolerance, PolylineSimplification method, size_t *indices) {
+	if(n <= 2) {
+		for(size_t i = 0; i < n; i++) indices[i] = i;
+		return n;
+	}
+	switch(method) {
+		case POLYLINE_SIMPLIFY_VISVALINGAM: return simplify_visvalingam(points, n, dim, tolerance, indices);
+		case POLYLINE_SIMPLIFY_STREAMING: return simplify_streaming(points, n, dim, tolerance, indices);
+		default: return simplify_rdp(points, n, dim, tolerance, indices);
+	}
+}
+
+size_t simplify_polyline2_indices(DataArray2 *line, double tolerance, PolylineSimplification method, size_t *indices) {
+	if(!line) return 0;
+	return simplify_polyline((const double *) line->data, line->count, 2, tolerance, method, indices);
+}
+
+size_t simplify_polyline3_indices(DataArray3 *line, double tolerance, PolylineSimplification method, size_t *indices) {
+	if(!line) return 0;
+	return simplify_polyline((const double *) line->data, line->count, 3, tolerance, method, indices);
+}
+
+DataArray2 * simplify_polyline2(DataArray2 *line, double tolerance, PolylineSimplification method) {
+	DataArray2 *simplified = data_array2_create();
+	if(!line || line->count == 0) return simplified;
+	size_t *indices = malloc(line->count * sizeof(size_t));
+	size_t num_kept = simplify_polyline2_indices(line, tolerance, method, indices);
+	data_array2_reserve(simplified, num_kept);
+	for(size_t i = 0; i < num_kept; i++) data_array2_append_new(simplified, line->data[indices[i]]);
+	free(indices);
+	return simplified;
+}
+
+DataArray3 * simplify_polyline3(DataArray3 *line, double tolerance, PolylineSimplification method) {
+	DataArray3 *simplified = data_array3_create();
+	if(!line || line->count == 0) return simplified;
+	size_t *indices = malloc(line->count * sizeof(size_t));
+	size_t num_kept = simplify_polyline3_indices(line, tolerance, method, indices);
+	data_array3_reserve(simplified, num_kept);
+	for(size_t i = 0; i < num_kept; i++) data_array3_append_new(simplified, line->data[indices[i]]);
+	free(indices);
+	return simplified;
+}
+
+PolylineSimplifier * polyline_simplifier_create(double tolerance) {
+	PolylineSimplifier *simplifier = malloc(sizeof(PolylineSimplifier));
+	simplifier->tolerance = tolerance;
+	polyline_simplifier_reset(simplifier);
+	return simplifier;
+}
+
+void polyline_simplifier_add2(PolylineSimplifier *simplifier, Vector2 point, DataArray2 *out) {
+	double p[2] = {point.x, point.y}, kept[3];
+	size_t kept_idx;
+	if(polyline_simplifier_push(simplifier, p, 2, kept, &kept_idx)) data_array2_append_new(out, vec2(kept[0], kept[1]));
+}
+
+void polyline_simplifier_add3(PolylineSimplifier *simplifier, Vector3 point, DataArray3 *out) {
+	double p[3] = {point.x, point.y, point.z}, kept[3];
+	size_t kept_idx;
+	if(polyline_simplifier_push(simplifier, p, 3, kept, &kept_idx)) data_array3_append_new(out, vec3(kept[0], kept[1], kept[2]));
+}
+
+void polyline_simplifier_finish2(PolylineSimplifier *simplifier, DataArray2 *out) {
+	double kept[3];
+	size_t kept_idx;
+	if(polyline_simplifier_pop_last(simplifier, kept, &kept_idx)) data_array2_append_new(out, vec2(kept[0], kept[1]));
+}
+
+void polyline_simplifier_finish3(PolylineSimplifier *simplifier, DataArray3 *out) {
+	double kept[3];
+	size_t kept_idx;
+	if(polyline_simplifier_pop_last(simplifier, kept, &kept_idx)) data_array3_append_new(out, vec3(kept[0], kept[1], kept[2]));
+}
+
+void polyline_simplifier_free(PolylineSimplifier *simplifier) {
+	free(simplifier);
+}
+
+
+/*
+ * ------------------------------------
+ * Segment Hierarchy
+ * ------------------------------------
+ */
+
+// maximal number of consecutive segments per leaf
+#define SEGMENT_HIERARCHY_LEAF_SIZE 8
+// enough for the depth of a hierarchy split at halves of the segment range
+#define SEGMENT_HIERARCHY_MAX_DEPTH 64
+// query points or segments per chunk of a parallel batch query (at least)
+#define SEGMENT_HIERARCHY_PARALLEL_MIN_QUERIES (1 << 12)
+
+// one cache line per node
+typedef struct HierarchyNode {
+	double min[3], max[3];
+	size_t first;	// leaf: first segment, inner node: index of the right child (the left child follows the node)
+	size_t count;	// leaf: number of segments, inner node: 0
+} HierarchyNode;
+
+typedef struct SegmentHierarchy {
+	int dim;
+	double *points;		// copy of the polyline (dim values per point)
+	size_t num_segments;
+	HierarchyNode *nodes;
+} SegmentHierarchy;
+
+struct PolylineBVH2 {
+	SegmentHierarchy tree;
+};
+
+struct PolylineBVH3 {
+	SegmentHierarchy tree;
+};
+
+typedef struct HierarchyQueryJob {
+	SegmentHierarchy *tree;
+	const double *queries;	// points or polyline (dim values each)
+	size_t num_queries;		// points or segments
+	size_t *segments;
+	double *closest;
+	DataArray2 **inters;	// intersections of each chunk
+	size_t num_chunks;
+} HierarchyQueryJob;
+
+static size_t count_hierarchy_nodes(size_t num_segments) {
+	if(num_segments <= SEGMENT_HIERARCHY_LEAF_SIZE) return 1;
+	return 1 + count_hierarchy_nodes(num_segments/2) + count_hierarchy_nodes(num_segments - num_segments/2);
+}
+
+// builds the subtree of the segments first..first+count-1 at node_idx and returns the index after the subtree
+static size_t build_hierarchy_node(SegmentHierarchy *tree, size_t node_idx, size_t first, size_t count) {
+	HierarchyNode *node = &tree->nodes[node_idx];
+	int dim = tree->dim;
+	if(count <= SEGMENT_HIERARCHY_LEAF_SIZE) {
+		*node = (HierarchyNode) {.first = first, .count = count};
+		for(int c = 0; c < dim; c++) node->min[c] = node->max[c] = tree->points[first*dim + c];
+		for(size_t i = first+1; i <= first+count; i++) {
+			for(int c = 0; c < dim; c++) {
+				node->min[c] = fmin(node->min[c], tree->points[i*dim + c]);
+				node->max[c] = fmax(node->max[c], tree->points[i*dim + c]);
+			}
+		}
+		return node_idx+1;
+	}
+	size_t right = build_hierarchy_node(tree, node_idx+1, first, count/2);
+	size_t next = build_hierarchy_node(tree, right, first + count/2, count - count/2);
+	HierarchyNode *left_node = &tree->nodes[node_idx+1], *right_node = &tree->nodes[right];
+	*node = (HierarchyNode) {.first = right, .count = 0};
+	for(int c = 0; c < dim; c++) {
+		node->min[c] = fmin(left_node->min[c], right_node->min[c]);
+		node->max[c] = fmax(left_node->max[c], right_node->max[c]);
+	}
+	return next;
+}
+
+static void build_segment_hierarchy(SegmentHierarchy *tree, const double *points, size_t num_points, int dim) {
+	*tree = (SegmentHierarchy) {.dim = dim};
+	if(num_points < 2) return;
+	tree->num_segments = num_points-1;
+	tree->points = malloc(num_points * dim * sizeof(double));
+	memcpy(tree->points, points, num_points * dim * sizeof(double));
+	size_t num_nodes = count_hierarchy_nodes(tree->num_segments);
+	tree->nodes = aligned_alloc(64, (num_nodes * sizeof(HierarchyNode) + 63) / 64 * 64);
+	build_hierarchy_node(tree, 0, 0, tree->num_segments);
+}
+
+static void free_segment_hierarchy(SegmentHierarchy *tree) {
+	free(tree->points);
+	free(tree->nodes);
+}
+
+static bool boxes_overlap(const double *min0, const double *max0, const double *min1, const double *max1, int dim) {
+	for(int c = 0; c < dim; c++) if(max0[c] < min1[c] || max1[c] < min0[c]) return false;
+	return true;
+}
+
+static double sq_distance_to_box(const double *p, const double *min, const double *max, int dim) {
+	double sq_dist = 0;
+	for(int c = 0; c < dim; c++) {
+		double d = p[c] < min[c] ? min[c] - p[c] : p[c] > max[c] ? p[c] - max[c] : 0;
+		sq_dist += d * d;
+	}
+	return sq_dist;
+}
+
+// segment clipped against the slabs of the box
+static bool segment_intersects_box(const double *a, const double *b, const double *min, const double *max, int dim) {
+	double t_min = 0, t_max = 1;
+	for(int c = 0; c < dim; c++) {
+		double d = b[c] - a[c];
+		if(d == 0) {
+			if(a[c] < min[c] || a[c] > max[c]) return false;
+			continue;
+		}
+		double t0 = (min[c] - a[c]) / d, t1 = (max[c] - a[c]) / d;
+		t_min = fmax(t_min, fmin(t0, t1));
+		t_max = fmin(t_max, fmax(t0, t1));
+		if(t_min > t_max) return false;
+	}
+	return true;
+}
+
+static double closest_point_on_segment(const double *p, const double *a, const double *b, int dim, double *closest) {
+	double ab[3], sq_ab = 0, t = 0;
+	for(int c = 0; c < dim; c++) {
+		ab[c] = b[c] - a[c];
+		sq_ab += ab[c] * ab[c];
+		t += (p[c] - a[c]) * ab[c];
+	}
+	t = sq_ab > 0 ? fmin(fmax(t / sq_ab, 0), 1) : 0;
+	double sq_dist = 0;
+	for(int c = 0; c < dim; c++) {
+		closest[c] = a[c] + t * ab[c];
+		sq_dist += (p[c] - closest[c]) * (p[c] - closest[c]);
+	}
+	return sq_dist;
+}
+
+// depth-first, nearer child first; subtrees farther than the best segment so far are skipped
+static size_t find_nearest_segment(SegmentHierarchy *tree, const double *p, double *closest) {
+	if(tree->num_segments == 0) return SIZE_MAX;
+	int dim = tree->dim;
+	size_t stack[SEGMENT_HIERARCHY_MAX_DEPTH], num_stack = 0, best = SIZE_MAX;
+	double best_sq_dist = INFINITY, candidate[3];
+	stack[num_stack++] = 0;
+	while(num_stack > 0) {
+		HierarchyNode *node = &tree->nodes[stack[--num_stack]];
+		if(sq_distance_to_box(p, node->min, node->max, dim) > best_sq_dist) continue;
+		if(node->count > 0) {
+			for(size_t s = node->first; s < node->first + node->count; s++) {
+				double sq_dist = closest_point_on_segment(p, tree->points + s*dim, tree->points + (s+1)*dim, dim, candidate);
+				if(sq_dist < best_sq_dist || (sq_dist == best_sq_dist && s < best)) {
+					best_sq_dist = sq_dist;
+					best = s;
+					if(closest) memcpy(closest, candidate, dim * sizeof(double));
+				}
+			}
+			continue;
+		}
+		size_t left = node - tree->nodes + 1, right = node->first;
+		double sq_dist_left = sq_distance_to_box(p, tree->nodes[left].min, tree->nodes[left].max, dim);
+		double sq_dist_right = sq_distance_to_box(p, tree->nodes[right].min, tree->nodes[right].max, dim);
+		if(sq_dist_left <= sq_dist_right) {
+			stack[num_stack++] = right;
+			stack[num_stack++] = left;
+		} else {
+			stack[num_stack++] = left;
+			stack[num_stack++] = right;
+		}
+	}
+	return best;
+}
+
+// leaves are visited in ascending order of their segments
+static size_t find_segments_in_box(SegmentHierarchy *tree, const double *min, const double *max, size_t *segments) {
+	if(tree->num_segments == 0) return 0;
+	int dim = tree->dim;
+	size_t stack[SEGMENT_HIERARCHY_MAX_DEPTH], num_stack = 0, num_found = 0;
+	stack[num_stack++] = 0;
+	while(num_stack > 0) {
+		size_t node_idx = stack[--num_stack];
+		HierarchyNode *node = &tree->nodes[node_idx];
+		if(!boxes_overlap(node->min, node->max, min, max, dim)) continue;
+		if(node->count > 0) {
+			for(size_t s = node->first; s < node->first + node->count; s++) {
+				if(segment_intersects_box(tree->points + s*dim, tree->points + (s+1)*dim, min, max, dim)) segments[num_found++] = s;
+			}
+			continue;
+		}
+		stack[num_stack++] = node->first;
+		stack[num_stack++] = node_idx+1;
+	}
+	return num_found;
+}
+
+static void intersect_hierarchy_with_segment(SegmentHierarchy *tree, Vector2 p0, Vector2 p1, DataArray2 *inters_points) {
+	if(tree->num_segments == 0) return;
+	double min[2] = {fmin(p0.x, p1.x), fmin(p0.y, p1.y)}, max[2] = {fmax(p0.x, p1.x), fmax(p0.y, p1.y)};
+	Vector2 *points = (Vector2 *) tree->points;
+	size_t stack[SEGMENT_HIERARCHY_MAX_DEPTH], num_stack = 0;
+	stack[num_stack++] = 0;
+	while(num_stack > 0) {
+		size_t node_idx = stack[--num_stack];
+		HierarchyNode *node = &tree->nodes[node_idx];
+		if(!boxes_overlap(node->min, node->max, min, max, 2)) continue;
+		if(node->count > 0) {
+			for(size_t s = node->first; s < node->first + node->count; s++) {
+				if(are_line_segments_intersecting2(p0, p1, points[s], points[s+1])) {
+					data_array2_append_new(inters_points, get_line_segment_intersection(p0, p1, points[s], points[s+1]));
+				}
+			}
+			continue;
+		}
+		stack[num_stack++] = node->first;
+		stack[num_stack++] = node_idx+1;
+	}
+}
+
+static void nearest_segments_chunk_task(void *ctx, size_t chunk) {
+	HierarchyQueryJob *job = ctx;
+	int dim = job->tree->dim;
+	size_t begin = job->num_queries * chunk / job->num_chunks;
+	size_t end = job->num_queries * (chunk+1) / job->num_chunks;
+	for(size_t q = begin; q < end; q++) {
+		// stays NAN if no segment is found (empty hierarchy or NaN query)
+		double closest[3] = {NAN, NAN, NAN};
+		job->segments[q] = find_nearest_segment(job->tree, job->queries + q*dim, closest);
+		if(job->closest) memcpy(job->closest + q*dim, closest, dim * sizeof(double));
+	}
+}
+
+static void line_intersections_chunk_task(void *ctx, size_t chunk) {
+	HierarchyQueryJob *job = ctx;
+	size_t begin = job->num_queries * chunk / job->num_chunks;
+	size_t end = job->num_queries * (chunk+1) / job->num_chunks;
+	const Vector2 *line = (const Vector2 *) job->queries;
+	job->inters[chunk] = data_array2_create();
+	for(size_t q = begin; q < end; q++) intersect_hierarchy_with_segment(job->tree, line[q], line[q+1], job->inters[chunk]);
+}
+
+static void find_nearest_segments(SegmentHierarchy *tree, const double *points, size_t num_points, size_t *segments, double *closest) {
+	size_t num_chunks = get_num_parallel_chunks(num_points, SEGMENT_HIERARCHY_PARALLEL_MIN_QUERIES);
+	HierarchyQueryJob job = {.tree = tree, .queries = points, .num_queries = num_points, .segments = segments, .closest = closest, .num_chunks = num_chunks};
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		job.num_chunks = 1;
+		nearest_segments_chunk_task(&job, 0);
+		return;
+	}
+	run_parallel_tasks(num_chunks, nearest_segments_chunk_task, &job);
+}
+
+PolylineBVH2 * polyline_bvh2_create(DataArray2 *line) {
+	PolylineBVH2 *bvh = malloc(sizeof(PolylineBVH2));
+	build_segment_hierarchy(&bvh->tree, line ? (const double *) line->data : NULL, line ? line->count : 0, 2);
+	return bvh;
+}
+
+PolylineBVH3 * polyline_bvh3_create(DataArray3 *line) {
+	PolylineBVH3 *bvh = malloc(sizeof(PolylineBVH3));
+	build_segment_hierarchy(&bvh->tree, line ? (const double *) line->data : NULL, line ? line->count : 0, 3);
+	return bvh;
+}
+
+void polyline_bvh2_free(PolylineBVH2 *bvh) {
+	if(!bvh) return;
+	free_segment_hierarchy(&bvh->tree);
+	free(bvh);
+}
+
+void polyline_bvh3_free(PolylineBVH3 *bvh) {
+	if(!bvh) return;
+	free_segment_hierarchy(&bvh->tree);
+	free(bvh);
+}
+
+DataArray2 * polyline_bvh2_get_segment_intersections(PolylineBVH2 *bvh, Vector2 p0, Vector2 p1) {
+	DataArray2 *inters_points = data_array2_create();
+	intersect_hierarchy_with_segment(&bvh->tree, p0, p1, inters_points);
+	return inters_points;
+}
+
+DataArray2 * polyline_bvh2_get_line_intersections(PolylineBVH2 *bvh, DataArray2 *line) {
+	if(!line || line->count < 2) return data_array2_create();
+	size_t num_segments = line->count-1;
+	size_t num_chunks = get_num_parallel_chunks(num_segments, SEGMENT_HIERARCHY_PARALLEL_MIN_QUERIES);
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		DataArray2 *inters_points = data_array2_create();
+		for(size_t q = 0; q < num_segments; q++) intersect_hierarchy_with_segment(&bvh->tree, line->data[q], line->data[q+1], inters_points);
+		return inters_points;
+	}
+
+	// chunks of query segments are concatenated in order, as in the serial loop
+	HierarchyQueryJob job = {
+		.tree = &bvh->tree,
+		.queries = (const double *) line->data,
+		.num_queries = num_segments,
+		.inters = malloc(num_chunks * sizeof(DataArray2 *)),
+		.num_chunks = num_chunks
+	};
+	run_parallel_tasks(num_chunks, line_intersections_chunk_task, &job);
+	size_t num_inters = 0;
+	for(size_t c = 0; c < num_chunks; c++) num_inters += job.inters[c]->count;
+	DataArray2 *inters_points = data_array2_create();
+	data_array2_reserve(inters_points, num_inters);
+	for(size_t c = 0; c < num_chunks; c++) {
+		for(size_t k = 0; k < job.inters[c]->count; k++) data_array2_append_new(inters_points, job.inters[c]->data[k]);
+		data_array2_free(job.inters[c]);
+	}
+	free(job.inters);
+	return inters_points;
+}
+
+size_t polyline_bvh2_nearest_segment(PolylineBVH2 *bvh, Vector2 point, Vector2 *closest) {
+	double p[2] = {point.x, point.y}, c[2] = {NAN, NAN};
+	size_t segment = find_nearest_segment(&bvh->tree, p, c);
+	if(closest) *closest = vec2(c[0], c[1]);
+	return segment;
+}
+
+size_t polyline_bvh3_nearest_segment(PolylineBVH3 *bvh, Vector3 point, Vector3 *closest) {
+	double p[3] = {point.x, point.y, point.z}, c[3] = {NAN, NAN, NAN};
+	size_t segment = find_nearest_segment(&bvh->tree, p, c);
+	if(closest) *closest = vec3(c[0], c[1], c[2]);
+	return segment;
+}
+
+void polyline_bvh2_nearest_segments(PolylineBVH2 *bvh, const Vector2 *points, size_t num_points, size_t *segments, Vector2 *closest) {
+	find_nearest_segments(&bvh->tree, (const double *) points, num_points, segments, (double *) closest);
+}
+
+void polyline_bvh3_nearest_segments(PolylineBVH3 *bvh, const Vector3 *points, size_t num_points, size_t *segments, Vector3 *closest) {
+	find_nearest_segments(&bvh->tree, (const double *) points, num_points, segments, (double *) closest);
+}
+
+size_t polyline_bvh2_segments_in_box(PolylineBVH2 *bvh, Vector2 min, Vector2 max, size_t *segments) {
+	double box_min[2] = {min.x, min.y}, box_max[2] = {max.x, max.y};
+	return find_segments_in_box(&bvh->tree, box_min, box_max, segments);
+}
+
+size_t polyline_bvh3_segments_in_box(PolylineBVH3 *bvh, Vector3 min, Vector3 max, size_t *segments) {
+	double box_min[3] = {min.x, min.y, min.z}, box_max[3] = {max.x, max.y, max.z};
+	return find_segments_in_box(&bvh->tree, box_min, box_max, segments);
+}
@@ -0,0 +1,192 @@
+#ifndef KMAT_SIMD_H
+#define KMAT_SIMD_H
+
+#include <stddef.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Kernels working on interleaved double data (1: double, 2: Vector2, 3: Vector3).
+ * Meant to be called with constant num_comp so that the loops get specialized.
+ */
+
+/**
+ * @brief Component-wise min and max of num_elem interleaved elements with num_comp components each
+ *
+ * Same semantics as a scalar "if(min > v) min = v" loop: NaN values are skipped unless the first element is NaN.
+ * num_elem has to be at least 1.
+ *
+ * @param data Interleaved data
+ * @param num_elem Number of elements
+ * @param num_comp Number of components per element (1, 2 or 3)
+ * @param min Output for the minimum of each component (num_comp values)
+ * @param max Output for the maximum of each component (num_comp values)
+ */
+static inline void simd_minmax_interleaved(const double *data, size_t num_elem, int num_comp, double *min, double *max) {
+	// one period of doubles that starts with component 0 again and fills whole registers (lcm(2, num_comp) * 2)
+	enum { MAX_PERIOD = 12 };
+	const size_t period = num_comp == 3 ? 12 : 8;
+	const size_t num_doubles = num_elem * num_comp;
+	size_t i = 0;
+
+	for(int c = 0; c < num_comp; c++) min[c] = max[c] = data[c];
+
+#ifdef __SSE2__
+	if(num_doubles >= period) {
+		__m128d acc_min[MAX_PERIOD/2], acc_max[MAX_PERIOD/2];
+		for(size_t q = 0; q < period/2; q++) {
+			acc_min[q] = _mm_set_pd(data[(2*q+1) % num_comp], data[(2*q) % num_comp]);
+			acc_max[q] = acc_min[q];
+		}
+		for(; i + period <= num_doubles; i += period) {
+			for(size_t q = 0; q < period/2; q++) {
+				__m128d v = _mm_loadu_pd(data + i + 2*q);
+				acc_min[q] = _mm_min_pd(v, acc_min[q]);
+				acc_max[q] = _mm_max_pd(v, acc_max[q]);
+			}
+		}
+		double lanes_min[MAX_PERIOD], lanes_max[MAX_PERIOD];
+		for(size_t q = 0; q < period/2; q++) {
+			_mm_storeu_pd(lanes_min + 2*q, acc_min[q]);
+			_mm_storeu_pd(lanes_max + 2*q, acc_max[q]);
+		}
+		for(size_t k = 0; k < period; k++) {
+			int c = (int) (k % num_comp);
+			if(min[c] > lanes_min[k]) min[c] = lanes_min[k];
+			if(max[c] < lanes_max[k]) max[c] = lanes_max[k];
+		}
+	}
+#else
+	if(num_doubles >= period) {
+		double acc_min[MAX_PERIOD], acc_max[MAX_PERIOD];
+		for(size_t k = 0; k < period; k++) acc_min[k] = acc_max[k] = data[k % num_comp];
+		for(; i + period <= num_doubles; i += period) {
+			for(size_t k = 0; k < period; k++) {
+				double v = data[i+k];
+				acc_min[k] = v < acc_min[k] ? v : acc_min[k];
+				acc_max[k] = v > acc_max[k] ? v : acc_max[k];
+			}
+		}
+		for(size_t k = 0; k < period; k++) {
+			int c = (int) (k % num_comp);
+			if(min[c] > acc_min[k]) min[c] = acc_min[k];
+			if(max[c] < acc_max[k]) max[c] = acc_max[k];
+		}
+	}
+#endif
+
+	// remaining elements (period always ends on an element boundary)
+	for(; i < num_doubles; i++) {
+		int c = (int) (i % num_comp);
+		if(min[c] > data[i]) min[c] = data[i];
+		if(max[c] < data[i]) max[c] = data[i];
+	}
+}
+
+/**
+ * @brief Component-wise sum of num_elem interleaved elements with num_comp components each
+ *
+ * Uses several independent accumulators, so the result may differ from a sequential sum in the last bits.
+ *
+ * @param data Interleaved data
+ * @param num_elem Number of elements
+ * @param num_comp Number of components per element (1, 2 or 3)
+ * @param sum Output for the sum of each component (num_comp values)
+ */
+static inline void simd_sum_interleaved(const double *data, size_t num_elem, int num_comp, double *sum) {
+	enum { MAX_PERIOD = 12 };
+	const size_t period = num_comp == 3 ? 12 : 8;
+	const size_t num_doubles = num_elem * num_comp;
+	size_t i = 0;
+
+	for(int c = 0; c < num_comp; c++) sum[c] = 0;
+
+#ifdef __SSE2__
+	if(num_doubles >= period) {
+		__m128d acc[MAX_PERIOD/2];
+		for(size_t q = 0; q < period/2; q++) acc[q] = _mm_setzero_pd();
+		for(; i + period <= num_doubles; i += period) {
+			for(size_t q = 0; q < period/2; q++) acc[q] = _mm_add_pd(acc[q], _mm_loadu_pd(data + i + 2*q));
+		}
+		double lanes[MAX_PERIOD];
+		for(size_t q = 0; q < period/2; q++) _mm_storeu_pd(lanes + 2*q, acc[q]);
+		for(size_t k = 0; k < period; k++) sum[k % num_comp] += lanes[k];
+	}
+#else
+	if(num_doubles >= period) {
+		double acc[MAX_PERIOD] = {0};
+		for(; i + period <= num_doubles; i += period) {
+			for(size_t k = 0; k < period; k++) acc[k] += data[i+k];
+		}
+		for(size_t k = 0; k < period; k++) sum[k % num_comp] += acc[k];
+	}
+#endif
+
+	for(; i < num_doubles; i++) sum[i % num_comp] += data[i];
+}
+
+/**
+ * @brief Linear interpolation of queries between bracketing points of an interleaved (x, y) array
+ *
+ * Query k is interpolated between point idx[k] and point idx[k]+1 with the same formula and rounding as
+ * interpolate_from_sorted_data_array2: (x - x0) * (y1 - y0) / (x1 - x0) + y0.
+ *
+ * @param points Interleaved (x, y) data
+ * @param idx Index of the left bracketing point of each query
+ * @param x Query x-values
+ * @param y Output for the interpolated y-values
+ * @param num Number of queries
+ */
+static inline void simd_lerp_indexed2(const double *points, const size_t *idx, const double *x, double *y, size_t num) {
+	size_t k = 0;
+#ifdef __SSE2__
+	for(; k + 2 <= num; k += 2) {
+		// (x0, y0) and (x1, y1) of both queries, transposed to (x0 of query 0, x0 of query 1) etc.
+		__m128d p0a = _mm_loadu_pd(points + 2*idx[k]), p1a = _mm_loadu_pd(points + 2*idx[k] + 2);
+		__m128d p0b = _mm_loadu_pd(points + 2*idx[k+1]), p1b = _mm_loadu_pd(points + 2*idx[k+1] + 2);
+		__m128d x0 = _mm_unpacklo_pd(p0a, p0b), y0 = _mm_unpackhi_pd(p0a, p0b);
+		__m128d x1 = _mm_unpacklo_pd(p1a, p1b), y1 = _mm_unpackhi_pd(p1a, p1b);
+		__m128d m = _mm_div_pd(_mm_sub_pd(y1, y0), _mm_sub_pd(x1, x0));
+		_mm_storeu_pd(y + k, _mm_add_pd(_mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(x + k), x0), m), y0));
+	}
+#endif
+	for(; k < num; k++) {
+		const double *p0 = points + 2*idx[k], *p1 = p0 + 2;
+		double m = (p1[1] - p0[1]) / (p1[0] - p0[0]);
+		y[k] = (x[k] - p0[0]) * m + p0[1];
+	}
+}
+
+/**
+ * @brief Finds the first element of interleaved (x, y) data whose y is outside of [lo, hi)
+ *
+ * NaN y-values count as outside. Used to skip runs of points that stay within one band between two levels.
+ *
+ * @param points Interleaved (x, y) data
+ * @param num Number of elements
+ * @param lo Lower bound of the band (inclusive, -INFINITY for none)
+ * @param hi Upper bound of the band (exclusive, INFINITY for none)
+ * @return Index of the first element outside of the band (num if all are inside)
+ */
+static inline size_t simd_find_y_outside2(const double *points, size_t num, double lo, double hi) {
+	size_t k = 0;
+#ifdef __SSE2__
+	const __m128d lo_v = _mm_set1_pd(lo), hi_v = _mm_set1_pd(hi);
+	for(; k + 4 <= num; k += 4) {
+		__m128d y01 = _mm_unpackhi_pd(_mm_loadu_pd(points + 2*k), _mm_loadu_pd(points + 2*k + 2));
+		__m128d y23 = _mm_unpackhi_pd(_mm_loadu_pd(points + 2*k + 4), _mm_loadu_pd(points + 2*k + 6));
+		__m128d in01 = _mm_and_pd(_mm_cmpge_pd(y01, lo_v), _mm_cmplt_pd(y01, hi_v));
+		__m128d in23 = _mm_and_pd(_mm_cmpge_pd(y23, lo_v), _mm_cmplt_pd(y23, hi_v));
+		if(_mm_movemask_pd(_mm_and_pd(in01, in23)) != 3) break;
+	}
+#endif
+	for(; k < num; k++) {
+		double y = points[2*k + 1];
+		if(!(y >= lo && y < hi)) return k;
+	}
+	return num;
+}
+
+#endif //KMAT_SIMD_H
@@ -0,0 +1,310 @@
+#include <math.h>
+#include <string.h>
+
+#include "geometrylib_spline.h"
+#include "data_array_def.h"
+#include "parallel.h"
+
+// allowed deviation of a knot from the uniform grid (relative to the spacing) for the arithmetic lookup
+#define SPLINE_UNIFORM_TOLERANCE 1e-9
+
+// interval [x, next x) with y = c[0] + c[1]*dx + c[2]*dx^2 + c[3]*dx^3 for dx = x - segment.x
+typedef struct SplineSegment {
+	double x;
+	double c[4];
+} SplineSegment;
+
+struct SplineTable {
+	SplineSegment *segments;	// count-1 intervals
+	size_t count;				// number of knots
+	double x_end;				// x of the last knot
+	bool uniform;
+	double inv_dx;
+};
+
+typedef struct SplineJob {
+	SplineTable *table;
+	const double *x;
+	double *y;
+	size_t num_x;
+	size_t num_chunks;
+} SplineJob;
+
+
+/*
+ * ------------------------------------
+ * Coefficients
+ * ------------------------------------
+ */
+
+// cubic Hermite interval from the values and slopes at both ends
+static void set_hermite_coefficients(SplineSegment *segment, double h, double y0, double y1, double t0, double t1) {
+	double delta = (y1 - y0) / h;
+	segment->c[0] = y0;
+	segment->c[1] = t0;
+	segment->c[2] = (3*delta - 2*t0 - t1) / h;
+	segment->c[3] = (t0 + t1 - 2*delta) / (h*h);
+}
+
+static void compute_natural_cubic(SplineTable *table, const Vector2 *p, size_t n) {
+	// second derivatives from the tridiagonal system (Thomas algorithm), zero at both ends
+	double *m = calloc(n, sizeof(double));
+	double *c_prime = calloc(n, sizeof(double));
+	for(size_t i = 1; i < n-1; i++) {
+		double h0 = p[i].x - p[i-1].x, h1 = p[i+1].x - p[i].x;
+		double rhs = 6 * ((p[i+1].y - p[i].y)/h1 - (p[i].y - p[i-1].y)/h0);
+		double diag = 2 * (h0 + h1) - h0 * c_prime[i-1];
+		c_prime[i] = h1 / diag;
+		m[i] = (rhs - h0 * m[i-1]) / diag;
+	}
+	for(size_t i = n-2; i > 0; i--) m[i] -= c_prime[i] * m[i+1];
+
+	for(size_t i = 0; i < n-1; i++) {
+		double h = p[i+1].x - p[i].x;
+		SplineSegment *segment = &table->segments[i];
+		segment->c[0] = p[i].y;
+		segment->c[1] = (p[i+1].y - p[i].y)/h - h * (2*m[i] + m[i+1]) / 6;
+		segment->c[2] = m[i] / 2;
+		segment->c[3] = (m[i+1] - m[i]) / (6*h);
+	}
+	free(m);
+	free(c_prime);
+}
+
+static void compute_akima(SplineTable *table, const Vector2 *p, size_t n) {
+	// secant slopes with two extrapolated ones at each end: slope[k+2] belongs to the interval k
+	double *slope = malloc((n+3) * sizeof(double));
+	for(size_t i = 0; i < n-1; i++) slope[i+2] = (p[i+1].y - p[i].y) / (p[i+1].x - p[i].x);
+	if(n == 2) slope[1] = slope[0] = slope[3] = slope[4] = slope[2];
+	else {
+		slope[1] = 2*slope[2] - slope[3];
+		slope[0] = 2*slope[1] - slope[2];
+		slope[n+1] = 2*slope[n] - slope[n-1];
+		slope[n+2] = 2*slope[n+1] - slope[n];
+	}
+
+	double *t = malloc(n * sizeof(double));
+	for(size_t i = 0; i < n; i++) {
+		double w0 = fabs(slope[i+3] - slope[i+2]), w1 = fabs(slope[i+1] - slope[i]);
+		t[i] = w0 + w1 > 0 ? (w0 * slope[i+1] + w1 * slope[i+2]) / (w0 + w1) : (slope[i+1] + slope[i+2]) / 2;
+	}
+	for(size_t i = 0; i < n-1; i++) set_hermite_coefficients(&table->segments[i], p[i+1].x - p[i].x, p[i].y, p[i+1].y, t[i], t[i+1]);
+	free(t);
+	free(slope);
+}
+
+// shape-preserving one-sided slope at an end of the knots
+static double pchip_end_slope(double h0, double h1, double delta0, double delta1) {
+	double t = ((2*h0 + h1) * delta0 - h0 * delta1) / (h0 + h1);
+	if((t > 0) != (delta0 > 0) || t == 0) return 0;
+	if((delta0 > 0) != (delta1 > 0) && fabs(t) > fabs(3*delta0)) return 3*delta0;
+	return t;
+}
+
+static void compute_pchip(SplineTable *table, const Vector2 *p, size_t n) {
+	double *delta = malloc((n-1) * sizeof(double));
+	double *t = malloc(n * sizeof(double));
+	for(size_t i = 0; i < n-1; i++) delta[i] = (p[i+1].y - p[i].y) / (p[i+1].x - p[i].x);
+
+	if(n == 2) t[0] = t[1] = delta[0];
+	else {
+		// weighted harmonic mean of the neighbouring secants, zero at local extrema
+		for(size_t i = 1; i < n-1; i++) {
+			if(delta[i-1] * delta[i] <= 0) {
+				t[i] = 0;
+				continue;
+			}
+			double h0 = p[i].x - p[i-1].x, h1 = p[i+1].x - p[i].x;
+			double w0 = 2*h1 + h0, w1 = h1 + 2*h0;
+			t[i] = (w0 + w1) / (w0/delta[i-1] + w1/delta[i]);
+		}
+		t[0] = pchip_end_slope(p[1].x - p[0].x, p[2].x - p[1].x, delta[0], delta[1]);
+		t[n-1] = pchip_end_slope(p[n-1].x - p[n-2].x, p[n-2].x - p[n-3].x, delta[n-2], delta[n-3]);
+	}
+	for(size_t i = 0; i < n-1; i++) set_hermite_coefficients(&table->segments[i], p[i+1].x - p[i].x, p[i].y, p[i+1].y, t[i], t[i+1]);
+	free(t);
+	free(delta);
+}
+
+
+/*
+ * ------------------------------------
+ * Create and Free
+ * ------------------------------------
+ */
+
+SplineTable * spline_table_create(DataArray2 *arr, SplineType type) {
+	if(!arr || arr->count < 2) return NULL;
+	const Vector2 *p = arr->data;
+	size_t n = arr->count;
+	for(size_t i = 0; i < n-1; i++) {
+		if(!(p[i+1].x > p[i].x)) return NULL;
+	}
+
+	SplineTable *table = malloc(sizeof(SplineTable));
+	table->segments = malloc((n-1) * sizeof(SplineSegment));
+	table->count = n;
+	table->x_end = p[n-1].x;
+	for(size_t i = 0; i < n-1; i++) table->segments[i].x = p[i].x;
+
+	switch(type) {
+		case SPLINE_AKIMA: compute_akima(table, p, n); break;
+		case SPLINE_PCHIP: compute_pchip(table, p, n); break;
+		default: compute_natural_cubic(table, p, n); break;
+	}
+
+	double dx = (p[n-1].x - p[0].x) / (double) (n-1);
+	table->uniform = true;
+	table->inv_dx = 1 / dx;
+	for(size_t i = 1; i < n-1 && table->uniform; i++) {
+		if(!(fabs(p[i].x - (p[0].x + (double) i * dx)) <= SPLINE_UNIFORM_TOLERANCE * dx)) table->uniform = false;
+	}
+	return table;
+}
+
+void spline_table_free(SplineTable *table) {
+	if(!table) return;
+	free(table->segments);
+	free(table);
+}
+
+size_t spline_table_size(SplineTable *table) {
+	return table ? table->count : 0;
+}
+
+
+/*
+ * ------------------------------------
+ * Evaluation
+ * ------------------------------------
+ */
+
+// moves an interval index to the last interval starting at or before x (x inside of the knots' range)
+static size_t correct_interval(const SplineTable *table, size_t idx, double x) {
+	const SplineSegment *segments = table->segments;
+	while(idx > 0 && segments[idx].x > x) idx--;
+	while(idx < table->count-2 && segments[idx+1].x <= x) idx++;
+	return idx;
+}
+
+static size_t find_interval(const SplineTable *table, double x) {
+	if(table->uniform) {
+		double guess = floor((x - table->segments[0].x) * table->inv_dx);
+		size_t idx = guess > 0 ? (guess < (double) (table->count-2) ? (size_t) guess : table->count-2) : 0;
+		return correct_interval(table, idx, x);
+	}
+	size_t lo = 0, hi = table->count-2;
+	while(lo < hi) {
+		size_t mid = (lo + hi + 1) / 2;
+		if(table->segments[mid].x <= x) lo = mid;
+		else hi = mid-1;
+	}
+	return lo;
+}
+
+// hunts for the interval of x, starting at idx (O(log distance))
+static size_t hunt_interval(const SplineTable *table, size_t idx, double x) {
+	const SplineSegment *segments = table->segments;
+	size_t last = table->count-2, lo, hi, probe, step = 1;
+	if(idx > last) idx = last;
+	if(segments[idx].x <= x) {
+		lo = idx;
+		probe = lo+1;
+		while(probe <= last && segments[probe].x <= x) {
+			lo = probe;
+			step *= 2;
+			probe = lo+step;
+		}
+		hi = probe <= last ? probe-1 : last;
+	} else {
+		// idx > 0 as the first interval starts at or before x
+		hi = idx-1;
+		probe = hi;
+		while(probe > 0 && segments[probe].x > x) {
+			hi = probe-1;
+			step *= 2;
+			probe = hi > step ? hi-step : 0;
+		}
+		lo = probe;
+	}
+	// the result lies in [lo, hi]
+	while(lo < hi) {
+		size_t mid = (lo + hi + 1) / 2;
+		if(segments[mid].x <= x) lo = mid;
+		else hi = mid-1;
+	}
+	return lo;
+}
+
+static inline double evaluate_segment(const SplineSegment *segment, double x) {
+	double dx = x - segment->x;
+	return ((segment->c[3] * dx + segment->c[2]) * dx + segment->c[1]) * dx + segment->c[0];
+}
+
+static inline bool is_outside(const SplineTable *table, double x) {
+	return !(x >= table->segments[0].x && x <= table->x_end);
+}
+
+double spline_table_evaluate(SplineTable *table, double x) {
+	if(!table || is_outside(table, x)) return NAN;
+	return evaluate_segment(&table->segments[find_interval(table, x)], x);
+}
+
+SplineCursor spline_cursor(SplineTable *table) {
+	return (SplineCursor) {table, 0};
+}
+
+double spline_evaluate_with_cursor(SplineCursor *cursor, double x) {
+	SplineTable *table = cursor->table;
+	if(!table || is_outside(table, x)) return NAN;
+	size_t idx = table->uniform ? find_interval(table, x) : hunt_interval(table, cursor->idx, x);
+	cursor->idx = idx;
+	return evaluate_segment(&table->segments[idx], x);
+}
+
+// evaluates sorted queries inside the knots' range with a merge walk over the intervals
+static void evaluate_sorted_range(const SplineTable *table, const double *x, double *y, size_t num_x) {
+	size_t idx = find_interval(table, x[0]), last = table->count-2;
+	for(size_t k = 0; k < num_x; k++) {
+		while(idx < last && table->segments[idx+1].x <= x[k]) idx++;
+		y[k] = evaluate_segment(&table->segments[idx], x[k]);
+	}
+}
+
+static void evaluate_chunk_task(void *ctx, size_t chunk) {
+	SplineJob *job = ctx;
+	size_t begin = job->num_x * chunk / job->num_chunks;
+	size_t end = job->num_x * (chunk+1) / job->num_chunks;
+	if(end > begin) evaluate_sorted_range(job->table, job->x + begin, job->y + begin, end-begin);
+}
+
+void spline_table_evaluate_values(SplineTable *table, const double *x, double *y, size_t num_x) {
+	if(num_x == 0) return;
+	if(!table) {
+		for(size_t k = 0; k < num_x; k++) y[k] = NAN;
+		return;
+	}
+
+	// queries outside of the knots' range are a prefix and a suffix of the sorted queries
+	size_t begin = 0, end = num_x;
+	while(begin < end && x[begin] < table->segments[0].x) y[begin++] = NAN;
+	while(end > begin && x[end-1] > table->x_end) y[--end] = NAN;
+	if(begin == end) return;
+
+	size_t num_chunks = get_num_parallel_chunks(end-begin, DATA_ARRAY_PARALLEL_MIN_CHUNK);
+	if(num_chunks == 1 || get_num_parallel_threads() == 1) {
+		evaluate_sorted_range(table, x + begin, y + begin, end-begin);
+		return;
+	}
+	SplineJob job = {table, x + begin, y + begin, end-begin, num_chunks};
+	run_parallel_tasks(num_chunks, evaluate_chunk_task, &job);
+}
+
+DataArray1 * spline_table_evaluate_batch(SplineTable *table, DataArray1 *x) {
+	DataArray1 *y = data_array1_create();
+	if(!x || x->count == 0) return y;
+	data_array1_reserve(y, x->count);
+	y->count = x->count;
+	spline_table_evaluate_values(table, x->data, y->data, x->count);
+	return y;
+}
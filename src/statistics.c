@@ -0,0 +1,364 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "geometrylib_statistics.h"
+#include "data_array_def.h"
+#include "simd.h"
+
+#define QUANTILE_SKETCH_MIN_K 8
+#define QUANTILE_SKETCH_MAX_LEVELS 64
+
+
+/*
+ * ------------------------------------
+ * Quickselect
+ * ------------------------------------
+ */
+
+static void swap_double(double *a, double *b) {
+	double tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+// moves the k-th smallest value of v[lo..hi] to index k with smaller or equal values to its left and bigger or equal to its right
+static void quickselect(double *v, ptrdiff_t lo, ptrdiff_t hi, ptrdiff_t k) {
+	while(hi > lo) {
+		if(hi - lo < 16) {
+			for(ptrdiff_t i = lo+1; i <= hi; i++) {
+				double value = v[i];
+				ptrdiff_t j = i-1;
+				while(j >= lo && v[j] > value) { v[j+1] = v[j]; j--; }
+				v[j+1] = value;
+			}
+			return;
+		}
+
+		// median of three (also acts as sentinels for the partition scans)
+		ptrdiff_t mid = lo + (hi-lo)/2;
+		if(v[mid] < v[lo]) swap_double(&v[mid], &v[lo]);
+		if(v[hi] < v[lo]) swap_double(&v[hi], &v[lo]);
+		if(v[hi] < v[mid]) swap_double(&v[hi], &v[mid]);
+		double pivot = v[mid];
+
+		ptrdiff_t i = lo, j = hi;
+		while(i <= j) {
+			while(v[i] < pivot) i++;
+			while(v[j] > pivot) j--;
+			if(i <= j) {
+				swap_double(&v[i], &v[j]);
+				i++; j--;
+			}
+		}
+
+		// [lo, j] <= pivot, [i, hi] >= pivot, everything in between equals pivot
+		if(k <= j) hi = j;
+		else if(k >= i) lo = i;
+		else return;
+	}
+}
+
+static double min_of_range(const double *v, ptrdiff_t lo, ptrdiff_t hi) {
+	double min = v[lo];
+	for(ptrdiff_t i = lo+1; i <= hi; i++) min = v[i] < min ? v[i] : min;
+	return min;
+}
+
+/*
+ * Selects the value of rank floor(h) in v[0..bound] (all values right of bound are bigger or equal)
+ * and interpolates towards the next rank. next_of_bound is the value with the rank after bound.
+ * Returns the selected index through idx and its successor value through next.
+ */
+static double select_interpolated(double *v, ptrdiff_t bound, double next_of_bound, double h, ptrdiff_t *idx, double *next) {
+	ptrdiff_t k = (ptrdiff_t) h;
+	if(k > bound) k = bound;
+	quickselect(v, 0, bound, k);
+	*idx = k;
+	*next = k == bound ? next_of_bound : min_of_range(v, k+1, bound);
+	double frac = h - (double) k;
+	if(frac <= 0 || isnan(*next)) return v[k];
+	return v[k] + frac * (*next - v[k]);
+}
+
+static DataStats1 stats_from_values(double *v, size_t n) {
+	if(n == 0) return (DataStats1) {NAN, NAN, NAN, NAN, NAN, NAN, 0};
+
+	DataStats1 stats;
+	double sum;
+	simd_minmax_interleaved(v, n, 1, &stats.min, &stats.max);
+	simd_sum_interleaved(v, n, 1, &sum);
+	stats.mean = sum / (double) n;
+	stats.count = n;
+
+	// select from the highest quantile down to only partition the left part further
+	ptrdiff_t idx3, idx_med, idx1;
+	double next3, next_med, next1;
+	double h_max = (double) (n-1);
+	stats.q3 = select_interpolated(v, (ptrdiff_t) n-1, NAN, 0.75*h_max, &idx3, &next3);
+	stats.median = select_interpolated(v, idx3, next3, 0.5*h_max, &idx_med, &next_med);
+	stats.q1 = select_interpolated(v, idx_med, next_med, 0.25*h_max, &idx1, &next1);
+
+	return stats;
+}
+
+static size_t copy_without_nan(const double *src, size_t n, double *dst) {
+	size_t count = 0;
+	for(size_t i = 0; i < n; i++) {
+		dst[count] = src[i];
+		count += !isnan(src[i]);
+	}
+	return count;
+}
+
+double data_array1_get_quantile(DataArray1 *arr, double q) {
+	if(!arr || arr->count == 0 || !(q >= 0 && q <= 1)) return NAN;
+	double *values = malloc(arr->count * sizeof(double));
+	size_t n = copy_without_nan(arr->data, arr->count, values);
+
+	double quantile = NAN;
+	if(n > 0) {
+		ptrdiff_t idx;
+		double next;
+		quantile = select_interpolated(values, (ptrdiff_t) n-1, NAN, q*(double) (n-1), &idx, &next);
+	}
+
+	free(values);
+	return quantile;
+}
+
+DataStats1 data_array1_get_stats(DataArray1 *arr) {
+	if(!arr || arr->count == 0) return stats_from_values(NULL, 0);
+	double *values = malloc(arr->count * sizeof(double));
+	size_t n = copy_without_nan(arr->data, arr->count, values);
+	DataStats1 stats = stats_from_values(values, n);
+	free(values);
+	return stats;
+}
+
+DataStats1 data_array1_get_stats_inplace(DataArray1 *arr) {
+	if(!arr || arr->count == 0) return stats_from_values(NULL, 0);
+	data_array1_make_writable(arr);
+
+	// move NaN values to the end
+	size_t n = 0;
+	for(size_t i = 0; i < arr->count; i++) {
+		if(!isnan(arr->data[i])) swap_double(&arr->data[n++], &arr->data[i]);
+	}
+
+	return stats_from_values(arr->data, n);
+}
+
+void print_data_stats1(DataStats1 stats) {
+	printf("Min: %f | Q1: %f | Median: %f | Q3: %f | Max: %f   (Avg: %f)\n",
+		stats.min, stats.q1, stats.median, stats.q3, stats.max, stats.mean);
+}
+
+
+/*
+ * ------------------------------------
+ * Streaming Quantile Sketch (KLL)
+ * ------------------------------------
+ */
+
+typedef struct KllCompactor {
+	double *items;
+	size_t count;
+	size_t capacity;
+} KllCompactor;
+
+struct QuantileSketch {
+	int k;
+	int num_levels;
+	KllCompactor levels[QUANTILE_SKETCH_MAX_LEVELS];
+	size_t num_retained;
+	size_t total_capacity;
+	size_t n;
+	double min;
+	double max;
+	double sum;
+	uint64_t rng_state;
+};
+
+typedef struct WeightedValue {
+	double value;
+	uint64_t weight;
+} WeightedValue;
+
+static int compare_doubles(const void *a, const void *b) {
+	double da = *(const double *) a, db = *(const double *) b;
+	return (da > db) - (da < db);
+}
+
+static int compare_weighted_values(const void *a, const void *b) {
+	return compare_doubles(&((const WeightedValue *) a)->value, &((const WeightedValue *) b)->value);
+}
+
+// capacity of level h; higher levels hold the heavier items and get the most space
+static size_t kll_level_capacity(QuantileSketch *sketch, int level) {
+	int depth = sketch->num_levels-1 - level;
+	size_t capacity = (size_t) ceil(sketch->k * pow(2.0/3.0, depth));
+	return capacity < 2 ? 2 : capacity;
+}
+
+static void kll_set_num_levels(QuantileSketch *sketch, int num_levels) {
+	sketch->num_levels = num_levels;
+	sketch->total_capacity = 0;
+	for(int h = 0; h < num_levels; h++) sketch->total_capacity += kll_level_capacity(sketch, h);
+}
+
+static void kll_push(KllCompactor *compactor, double value) {
+	if(compactor->count >= compactor->capacity) {
+		compactor->capacity = compactor->capacity ? compactor->capacity*2 : 16;
+		compactor->items = realloc(compactor->items, compactor->capacity * sizeof(double));
+	}
+	compactor->items[compactor->count++] = value;
+}
+
+static uint64_t kll_random(QuantileSketch *sketch) {
+	// xorshift64
+	uint64_t x = sketch->rng_state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	sketch->rng_state = x;
+	return x;
+}
+
+// halves level h by promoting every other (sorted) item to level h+1
+static void kll_compact_level(QuantileSketch *sketch, int level) {
+	if(level+1 >= QUANTILE_SKETCH_MAX_LEVELS) return;
+	if(level+1 >= sketch->num_levels) kll_set_num_levels(sketch, level+2);
+
+	KllCompactor *compactor = &sketch->levels[level];
+	qsort(compactor->items, compactor->count, sizeof(double), compare_doubles);
+
+	// an odd item stays on this level
+	size_t num_compact = compactor->count & ~(size_t) 1;
+	size_t offset = kll_random(sketch) & 1;
+	for(size_t i = offset; i < num_compact; i += 2) kll_push(&sketch->levels[level+1], compactor->items[i]);
+
+	if(compactor->count & 1) compactor->items[0] = compactor->items[compactor->count-1];
+	compactor->count -= num_compact;
+	sketch->num_retained -= num_compact/2;
+}
+
+static void kll_compress(QuantileSketch *sketch) {
+	while(sketch->num_retained >= sketch->total_capacity) {
+		int level = 0;
+		while(level < sketch->num_levels-1 && sketch->levels[level].count < kll_level_capacity(sketch, level)) level++;
+		size_t num_retained = sketch->num_retained;
+		kll_compact_level(sketch, level);
+		if(sketch->num_retained == num_retained) break;
+	}
+}
+
+QuantileSketch * quantile_sketch_create(int k) {
+	QuantileSketch *sketch = calloc(1, sizeof(QuantileSketch));
+	sketch->k = k < QUANTILE_SKETCH_MIN_K ? QUANTILE_SKETCH_MIN_K : k;
+	kll_set_num_levels(sketch, 1);
+	sketch->min = NAN;
+	sketch->max = NAN;
+	sketch->rng_state = 0x9E3779B97F4A7C15ull;
+	return sketch;
+}
+
+void quantile_sketch_free(QuantileSketch *sketch) {
+	if(!sketch) return;
+	for(int h = 0; h < QUANTILE_SKETCH_MAX_LEVELS; h++) free(sketch->levels[h].items);
+	free(sketch);
+}
+
+void quantile_sketch_add(QuantileSketch *sketch, double value) {
+	if(isnan(value)) return;
+	if(sketch->n == 0 || value < sketch->min) sketch->min = value;
+	if(sketch->n == 0 || value > sketch->max) sketch->max = value;
+	sketch->sum += value;
+	sketch->n++;
+
+	kll_push(&sketch->levels[0], value);
+	sketch->num_retained++;
+	if(sketch->num_retained >= sketch->total_capacity) kll_compress(sketch);
+}
+
+void quantile_sketch_add_data_array1(QuantileSketch *sketch, DataArray1 *arr) {
+	if(!arr) return;
+	for(size_t i = 0; i < arr->count; i++) quantile_sketch_add(sketch, arr->data[i]);
+}
+
+void quantile_sketch_merge(QuantileSketch *dst, QuantileSketch *src) {
+	if(!dst || !src || src->n == 0) return;
+
+	if(dst->n == 0 || src->min < dst->min) dst->min = src->min;
+	if(dst->n == 0 || src->max > dst->max) dst->max = src->max;
+	dst->sum += src->sum;
+	dst->n += src->n;
+
+	if(src->num_levels > dst->num_levels) kll_set_num_levels(dst, src->num_levels);
+	for(int h = 0; h < src->num_levels; h++) {
+		KllCompactor *compactor = &src->levels[h];
+		for(size_t i = 0; i < compactor->count; i++) kll_push(&dst->levels[h], compactor->items[i]);
+		dst->num_retained += compactor->count;
+	}
+
+	kll_compress(dst);
+}
+
+size_t quantile_sketch_count(QuantileSketch *sketch) {
+	return sketch ? sketch->n : 0;
+}
+
+// gathers all retained items with their weights, sorted by value
+static WeightedValue * kll_sorted_items(QuantileSketch *sketch, size_t *num_items) {
+	WeightedValue *items = malloc(sketch->num_retained * sizeof(WeightedValue));
+	size_t count = 0;
+	for(int h = 0; h < sketch->num_levels; h++) {
+		KllCompactor *compactor = &sketch->levels[h];
+		for(size_t i = 0; i < compactor->count; i++) {
+			items[count++] = (WeightedValue) {compactor->items[i], (uint64_t) 1 << h};
+		}
+	}
+	qsort(items, count, sizeof(WeightedValue), compare_weighted_values);
+	*num_items = count;
+	return items;
+}
+
+static double kll_quantile_from_sorted(QuantileSketch *sketch, WeightedValue *items, size_t num_items, double q) {
+	if(q <= 0) return sketch->min;
+	if(q >= 1) return sketch->max;
+
+	double target = q * (double) sketch->n;
+	uint64_t cumulative = 0;
+	for(size_t i = 0; i < num_items; i++) {
+		cumulative += items[i].weight;
+		if((double) cumulative > target) return items[i].value;
+	}
+	return sketch->max;
+}
+
+double quantile_sketch_get_quantile(QuantileSketch *sketch, double q) {
+	if(!sketch || sketch->n == 0 || !(q >= 0 && q <= 1)) return NAN;
+	size_t num_items;
+	WeightedValue *items = kll_sorted_items(sketch, &num_items);
+	double quantile = kll_quantile_from_sorted(sketch, items, num_items, q);
+	free(items);
+	return quantile;
+}
+
+DataStats1 quantile_sketch_get_stats(QuantileSketch *sketch) {
+	if(!sketch || sketch->n == 0) return (DataStats1) {NAN, NAN, NAN, NAN, NAN, NAN, 0};
+
+	size_t num_items;
+	WeightedValue *items = kll_sorted_items(sketch, &num_items);
+	DataStats1 stats = {
+		.min = sketch->min,
+		.q1 = kll_quantile_from_sorted(sketch, items, num_items, 0.25),
+		.median = kll_quantile_from_sorted(sketch, items, num_items, 0.5),
+		.q3 = kll_quantile_from_sorted(sketch, items, num_items, 0.75),
+		.max = sketch->max,
+		.mean = sketch->sum / (double) sketch->n,
+		.count = sketch->n
+	};
+	free(items);
+	return stats;
+}